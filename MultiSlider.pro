@@ -4,21 +4,14 @@
 #
 #-------------------------------------------------
 
-QT       += core gui
+TEMPLATE = subdirs
 
-greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
+SUBDIRS += \
+    MultiSlider \
+    demo \
+    benchmarks \
+    tests
 
-TARGET = MultiSlider
-TEMPLATE = app
-
-
-SOURCES += main.cpp\
-    MultiSlider/MultiSlider.cpp \
-    MultiSlider/MultiSliderWidget.cpp
-
-HEADERS  += MultiSlider/MultiSlider.h \
-    MultiSlider/MultiSlider_p.h \
-    MultiSlider/MultiSliderWidget.h
-
-RESOURCES += \
-    MultiSlider/res.qrc
+demo.depends = MultiSlider
+benchmarks.depends = MultiSlider
+tests.depends = MultiSlider
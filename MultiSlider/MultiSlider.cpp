@@ -0,0 +1,1880 @@
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QLoggingCategory>
+#include <QMouseEvent>
+#include <QKeyEvent>
+#include <QStyleOptionSlider>
+#include <QApplication>
+#include <QStylePainter>
+#include <QPainter>
+#include <QPen>
+#include <QPixmap>
+#include <QStyle>
+#include <QToolTip>
+#include <QGuiApplication>
+#include <QScreen>
+#include <QWindow>
+
+#include <algorithm>
+#include <limits>
+
+#include "MultiSlider.h"
+#include "MultiSlider_p.h"
+
+namespace
+{
+/// count of different colors of segments, see MultiSlider::color
+const int ColorsCount = 7;
+
+/// interval of stats output to multislider.stats logging category, in milliseconds
+const int StatsLogInterval = 1000;
+
+QRect AdjustRectForMac(const QRect& rect)
+{
+    return rect.adjusted(3, 2, -3, -2);
+}
+
+/// adds time spent in its scope to given counter, does nothing for null counter
+class StatsTimer
+{
+public:
+    explicit StatsTimer(qint64* nsecs)
+        : m_nsecs(nsecs)
+    {
+        if (m_nsecs)
+        {
+            m_timer.start();
+        }
+    }
+
+    ~StatsTimer()
+    {
+        if (m_nsecs)
+        {
+            *m_nsecs += m_timer.nsecsElapsed();
+        }
+    }
+
+private:
+    qint64* m_nsecs;
+    QElapsedTimer m_timer;
+};
+
+/// copy of all handles of the model
+QVector<int> HandlesVector(const MultiSliderModel::Handles& handles)
+{
+    return QVector<int>(handles.constBegin(), handles.constEnd());
+}
+
+/// copy handles [first, last) of the model into buffer, allocates only when buffer is shared or grows
+void CopyHandles(const MultiSliderModel::Handles& handles, int first, int last, QVector<int>& buffer)
+{
+    buffer.resize(last - first);
+    std::copy(handles.constData() + first, handles.constData() + last, buffer.begin());
+}
+
+/// first index in [first, last) for which pred is false, pred must be true before it and false after.
+/// Searches by index, so the model folds no pending shifts, see MultiSliderModel::position
+template<typename Pred>
+int PartitionPoint(int first, int last, Pred pred)
+{
+    while (first < last)
+    {
+        const int middle = first + (last - first) / 2;
+        if (pred(middle))
+        {
+            first = middle + 1;
+        }
+        else
+        {
+            last = middle;
+        }
+    }
+    return first;
+}
+}
+
+// disabled by default, enable with QT_LOGGING_RULES="multislider.stats.debug=true"
+Q_LOGGING_CATEGORY(multiSliderStats, "multislider.stats", QtInfoMsg)
+
+MultiSliderPrivate::MultiSliderPrivate(MultiSlider& object)
+  :q_ptr(&object)
+  , m_subclassClickOffset(0)
+  , m_subclassPosition(0)
+  , m_subclassWidth(0.0)
+  , m_levelOfDetail(true)
+  , m_fullVectorSignals(false)
+  , m_transactionDepth(0)
+  , m_transactionValues(false)
+  , m_transactionWithoutUndo(false)
+  , m_snapToTicks(false)
+  , m_snapGrid(0)
+  , m_snapDistance(0)
+  , m_applyingJournal(false)
+  , m_dragCoalescing(false)
+  , m_dragPending(false)
+  , m_pendingDragPos(0)
+  , m_spriteDevicePixelRatio(0.)
+{
+    m_dragTimer.setSingleShot(true);
+    m_dragTimer.setTimerType(Qt::PreciseTimer);
+}
+
+void MultiSliderPrivate::init()
+{
+    Q_Q(MultiSlider);
+    setColorScheme(QVector<QColor>());
+    m_model.setRange(q->minimum(), q->maximum());
+    q->refreshMaxCount();
+    q->connect(q, &MultiSlider::rangeChanged, q, &MultiSlider::onRangeChanged);
+    q->connect(q, &MultiSlider::rangeChanged, q, &MultiSlider::refreshMaxCount);
+    q->connect(q, &MultiSlider::countChanged, q, &MultiSlider::refreshMaxCount);
+    q->connect(&m_dragTimer, &QTimer::timeout, q, &MultiSlider::flushPendingDrag);
+    q->connect(&m_statsTimer, &QTimer::timeout, q, &MultiSlider::logStats);
+}
+
+int MultiSlider::frameInterval() const
+{
+    const QWindow* window = this->window()->windowHandle();
+    const QScreen* screen = window ? window->screen() : QGuiApplication::primaryScreen();
+    const qreal refreshRate = screen ? screen->refreshRate() : 60.;
+    return qMax(1, qRound(1000. / (refreshRate > 0 ? refreshRate : 60.)));
+}
+
+void MultiSliderPrivate::setColorScheme(const QVector<QColor>& colors)
+{
+    m_colorScheme = colors;
+    if (m_colorScheme.isEmpty())
+    {
+        for (int i = 0; i < ColorsCount; ++i)
+        {
+            m_colorScheme.append(MultiSlider::color(i, 0.5));
+        }
+    }
+    m_palette.resize(m_colorScheme.size());
+    for (int i = 0; i < m_colorScheme.size(); ++i)
+    {
+        const QColor& color = m_colorScheme.at(i);
+        SegmentPalette& palette = m_palette[i];
+        palette.brush = QBrush(color);
+        palette.pen = QPen(color.darker(150), 0);
+        palette.background = QColor::fromHslF(qMax(color.hslHueF(), 0.), color.hslSaturationF(), 0.93);
+    }
+}
+
+const MultiSliderPrivate::Geometry& MultiSliderPrivate::geometry() const
+{
+    Q_Q(const MultiSlider);
+    if (!m_geometry.valid
+            || m_geometry.orientation != q->orientation()
+            || m_geometry.invertedAppearance != q->invertedAppearance()
+            || m_geometry.tickPosition != q->tickPosition()
+            || m_geometry.minimum != q->minimum()
+            || m_geometry.maximum != q->maximum()
+            || m_geometry.size != q->size())
+    {
+        rebuildGeometry();
+    }
+    return m_geometry;
+}
+
+void MultiSliderPrivate::invalidateGeometry()
+{
+    m_geometry.valid = false;
+}
+
+void MultiSliderPrivate::rebuildGeometry() const
+{
+    Q_Q(const MultiSlider);
+    QStyleOptionSlider option;
+    q->initStyleOption( &option );
+    option.sliderPosition = q->minimum();
+    option.sliderValue = q->minimum();
+
+    Geometry& g = m_geometry;
+    g.groove = q->style()->subControlRect( QStyle::CC_Slider,
+                                           &option,
+                                           QStyle::SC_SliderGroove,
+                                           q );
+    g.handle = q->style()->subControlRect( QStyle::CC_Slider,
+                                           &option,
+                                           QStyle::SC_SliderHandle,
+                                           q );
+    // Copied verbatim from QSliderPrivate::pixelPosToRangeValue. See QSlider.cpp
+    int sliderMax;
+    if (option.orientation == Qt::Horizontal)
+    {
+        g.sliderMin = g.groove.x();
+        sliderMax = g.groove.right() - g.handle.width() + 1;
+    }
+    else
+    {
+        g.sliderMin = g.groove.y();
+        sliderMax = g.groove.bottom() - g.handle.height() + 1;
+    }
+    g.span = sliderMax - g.sliderMin;
+    g.spaceAvailable = q->style()->pixelMetric(QStyle::PM_SliderSpaceAvailable, &option, q);
+    g.upsideDown = option.upsideDown;
+    g.isMac = q->style()->objectName() == "macintosh";
+    // handle look depends on orientation, tick position and size, which are all rebuilt here
+    m_handleSprites.clear();
+
+    g.orientation = q->orientation();
+    g.invertedAppearance = q->invertedAppearance();
+    g.tickPosition = q->tickPosition();
+    g.minimum = q->minimum();
+    g.maximum = q->maximum();
+    g.size = q->size();
+    g.valid = true;
+
+    g.handleOffset = (g.orientation == Qt::Horizontal ? g.handle.left() : g.handle.top())
+            - pixelPosFromRangeValue(g.minimum);
+}
+
+int MultiSliderPrivate::tickInterval() const
+{
+    Q_Q(const MultiSlider);
+    int interval = q->tickInterval();
+    if (interval <= 0)
+    {
+        interval = q->singleStep();
+        const int available = geometry().spaceAvailable;
+        if (QStyle::sliderPositionFromValue(q->minimum(), q->maximum(), interval, available)
+                - QStyle::sliderPositionFromValue(q->minimum(), q->maximum(), 0, available) < 3)
+        {
+            interval = q->pageStep();
+        }
+    }
+    return interval ? interval : 1;
+}
+
+QRect MultiSliderPrivate::handleRect(int value) const
+{
+    const Geometry& g = geometry();
+    QRect rect = g.handle;
+    const int pos = pixelPosFromRangeValue(value) + g.handleOffset;
+    if (g.orientation == Qt::Horizontal)
+    {
+        rect.moveLeft(pos);
+    }
+    else
+    {
+        rect.moveTop(pos);
+    }
+    return rect;
+}
+
+QPair<int, int> MultiSliderPrivate::handlesInSpan(int from, int to) const
+{
+    const Geometry& g = geometry();
+    const int length = g.orientation == Qt::Horizontal ? g.handle.width() : g.handle.height();
+    const auto handleStart = [this, &g](int index) {
+        return pixelPosFromRangeValue(m_model.position(index)) + g.handleOffset;
+    };
+    const int count = m_model.count();
+    // handle rects are sorted along the slider, see handleAtPos
+    if (g.upsideDown)
+    {
+        const int first = PartitionPoint(0, count, [&](int i) { return handleStart(i) > to; });
+        const int last = PartitionPoint(first, count, [&](int i) { return handleStart(i) + length - 1 >= from; });
+        return qMakePair(first, last);
+    }
+    const int first = PartitionPoint(0, count, [&](int i) { return handleStart(i) + length - 1 < from; });
+    const int last = PartitionPoint(first, count, [&](int i) { return handleStart(i) <= to; });
+    return qMakePair(first, last);
+}
+
+void MultiSliderPrivate::updateHandles(int first, int last)
+{
+    Q_Q(MultiSlider);
+    // Moved handles stay between not moved neighbours, so the span between the
+    // neighbours holds old and new handle rects together with colored segments
+    const QRect from = handleRect(first ? m_model.position(first - 1) : q->minimum());
+    const QRect to = handleRect(last < m_model.count() ? m_model.position(last) : q->maximum());
+    updateSpan(from.united(to));
+}
+
+void MultiSliderPrivate::updateHandle(int index)
+{
+    updateSpan(handleRect(m_model.position(index)));
+}
+
+void MultiSliderPrivate::updateSpan(const QRect& rect)
+{
+    Q_Q(MultiSlider);
+    // styles can draw a bit outside of handle rect
+    const int margin = 2;
+    if (geometry().orientation == Qt::Horizontal)
+    {
+        q->update(rect.left() - margin, 0, rect.width() + 2 * margin, q->height());
+    }
+    else
+    {
+        q->update(0, rect.top() - margin, q->width(), rect.height() + 2 * margin);
+    }
+}
+
+int MultiSliderPrivate::handleAtPos(const QPoint& pos, QRect &handleRect) const
+{
+    const StatsTimer timer(m_stats ? &m_stats->hitTestNsecs : nullptr);
+    if (m_stats)
+    {
+        ++m_stats->hitTests;
+    }
+    const Geometry& g = geometry();
+    const bool horizontal = g.orientation == Qt::Horizontal;
+    const int mepos = horizontal ? pos.x() : pos.y();
+    const int length = horizontal ? g.handle.width() : g.handle.height();
+
+    // Positions are sorted and all handles have the same size, so handle rects
+    // are sorted along the slider too. The last handle under the pos is the one
+    // painted on top; it is the last one which starts before pos (or, if the
+    // slider is upside down, the last one which ends after pos).
+    const auto handleStart = [this, &g](int index) {
+        return pixelPosFromRangeValue(m_model.position(index)) + g.handleOffset;
+    };
+    const int found = g.upsideDown
+            ? PartitionPoint(0, m_model.count(), [&](int i) { return handleStart(i) + length - 1 >= mepos; })
+            : PartitionPoint(0, m_model.count(), [&](int i) { return handleStart(i) <= mepos; });
+    if (found == 0)
+    {
+        return -1;
+    }
+    const int i = found - 1;
+    const QRect rect = this->handleRect(m_model.position(i));
+    if (!rect.contains(pos))
+    {
+        return -1;
+    }
+    handleRect = rect;
+    return i;
+}
+
+int MultiSliderPrivate::posBetweenHandles(QPoint pos) const
+{
+    const StatsTimer timer(m_stats ? &m_stats->hitTestNsecs : nullptr);
+    if (m_stats)
+    {
+        ++m_stats->hitTests;
+    }
+    const Geometry& g = geometry();
+    const bool horizontal = g.orientation == Qt::Horizontal;
+    // handle centers are compared with pos from left to right on horizontal slider
+    // and from bottom to top on vertical one. If handles go in other direction
+    // the pos never can be between them.
+    if (m_model.count() < 2 || horizontal == g.upsideDown)
+    {
+        return -1;
+    }
+    const int sign = horizontal ? 1 : -1;
+    const int mepos = sign * (horizontal ? pos.x() : pos.y());
+
+    // adjusting rect for mac style does not move its center
+    const auto center = [this, horizontal, sign](int position) {
+        const QRect rect = handleRect(position);
+        return sign * (horizontal ? rect.center().x() : rect.center().y());
+    };
+    const int i = PartitionPoint(0, m_model.count(), [&](int index) { return center(m_model.position(index)) < mepos; }) - 1;
+    if (i < 0 || i >= m_model.count() - 1 || center(m_model.position(i + 1)) <= mepos)
+    {
+        return -1;
+    }
+    return i;
+}
+
+// --------------------------------------------------------------------------
+// Same as QSliderPrivate::pixelPosToRangeValue (see QSlider.cpp),
+// but reads groove and handle sizes from the cached geometry
+//
+int MultiSliderPrivate::pixelPosToRangeValue( int pos ) const
+{
+    const Geometry& g = geometry();
+    return QStyle::sliderValueFromPosition( g.minimum,
+                                            g.maximum,
+                                            pos - g.sliderMin,
+                                            g.span,
+                                            g.upsideDown );
+}
+
+int MultiSliderPrivate::pixelPosFromRangeValue( int val ) const
+{
+    const Geometry& g = geometry();
+    return QStyle::sliderPositionFromValue( g.minimum,
+                                            g.maximum,
+                                            val,
+                                            g.span,
+                                            g.upsideDown ) + g.sliderMin;
+}
+
+// Draw slider at the bottom end of the range
+void MultiSliderPrivate::drawHandle(int num, QStylePainter* painter ) const
+{
+    Q_Q(const MultiSlider);
+    const qreal devicePixelRatio = painter->device()->devicePixelRatioF();
+    if (devicePixelRatio != m_spriteDevicePixelRatio)
+    {
+        m_handleSprites.clear();
+        m_spriteDevicePixelRatio = devicePixelRatio;
+    }
+    const bool selected = m_selectedHandles.contains(num);
+    const QRect rect = handleRect(m_model.position(num));
+    if (m_stats)
+    {
+        ++m_stats->itemsDrawn;
+    }
+    if(geometry().isMac)
+    {
+        // On mac style, drawing just the handle actually draws also the groove.
+        const QRect clip = AdjustRectForMac(rect);
+        // knob images do not depend on style option
+        const SpriteKey key{ selected ? QStyle::State_Sunken : QStyle::State_None, QStyle::SC_None, -1,
+                             clip.size(), Qt::Horizontal, QSlider::NoTicks, false, Qt::LeftToRight };
+        auto sprite = m_handleSprites.constFind(key);
+        if (sprite == m_handleSprites.constEnd())
+        {
+            QString path = QString(":/Icons/knob") + (selected ? "_selected" : "") + ".png";
+            QPixmap pixmap = QPixmap(path).scaled(clip.size() * devicePixelRatio, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+            pixmap.setDevicePixelRatio(devicePixelRatio);
+            sprite = m_handleSprites.insert(key, pixmap);
+        }
+        painter->drawPixmap(clip.topLeft(), *sprite);
+        return;
+    }
+
+    QStyleOptionSlider option;
+    q->initSliderStyleOption(num, &option );
+
+    option.subControls = QStyle::SC_SliderHandle;
+    option.sliderValue = m_model.value(num);
+    option.sliderPosition = m_model.position(num);
+    if (selected)
+    {
+        option.activeSubControls = QStyle::SC_SliderHandle;
+        option.state |= QStyle::State_Sunken;
+    }
+
+    // Handle looks the same at any position, so it is rendered once for each
+    // look and then copied. Styles may draw a bit outside of handle rect.
+    const int margin = 2;
+    const QRect spriteRect = rect.adjusted(-margin, -margin, margin, margin);
+    const SpriteKey key{ option.state, option.activeSubControls, option.palette.cacheKey(),
+                         option.rect.size(), option.orientation, option.tickPosition,
+                         option.upsideDown, option.direction };
+    auto sprite = m_handleSprites.constFind(key);
+    if (sprite == m_handleSprites.constEnd())
+    {
+        QPixmap pixmap(spriteRect.size() * devicePixelRatio);
+        pixmap.setDevicePixelRatio(devicePixelRatio);
+        pixmap.fill(Qt::transparent);
+        QPainter spritePainter(&pixmap);
+        spritePainter.translate(-spriteRect.topLeft());
+        q->style()->drawComplexControl(QStyle::CC_Slider, &option, &spritePainter, q);
+        spritePainter.end();
+        sprite = m_handleSprites.insert(key, pixmap);
+    }
+    painter->drawPixmap(spriteRect.topLeft(), *sprite);
+}
+
+void MultiSliderPrivate::clearHandleSprites()
+{
+    m_handleSprites.clear();
+}
+
+QRect MultiSliderPrivate::segmentRect(int pos, int nextPos) const
+{
+    const Geometry& g = geometry();
+    const QRect lr = handleRect(pos);
+    const QRect ur = handleRect(nextPos);
+
+    if (g.orientation == Qt::Horizontal)
+    {
+        const int padding = g.isMac ? 5 : 2;
+        return QRect(
+                        QPoint(qMin( lr.left(), ur.center().x()) + (pos != 0 ? 10 : 0), g.groove.center().y() - 2),
+                        QPoint(qMax( lr.left(), ur.right() - padding) , g.groove.center().y() + 1));
+    }
+    return QRect(
+                    QPoint(g.groove.center().x() - 2, qMin( lr.center().y(), ur.center().y() )),
+                    QPoint(g.groove.center().x() + 1, qMax( lr.center().y(), ur.top())));
+}
+
+int MultiSliderPrivate::segmentColorIndex(int segment) const
+{
+    // last segment skips one color, it is how slider was always painted
+    const int count = m_model.count();
+    const int index = (segment == count && segment != 0) ? count + 1 : segment;
+    return index % m_palette.size();
+}
+
+void MultiSliderPrivate::clearSegments()
+{
+    m_segmentRects.resize(m_palette.size());
+    for(QVector<QRect>& rects : m_segmentRects)
+    {
+        rects.resize(0);
+    }
+}
+
+QVector<QRect>& MultiSliderPrivate::segmentsOfColor(int colorIndex)
+{
+    return m_segmentRects[colorIndex];
+}
+
+void MultiSliderPrivate::drawSegments(QStylePainter* painter)
+{
+    for(int i = 0;  i < m_segmentRects.size(); ++i)
+    {
+        const QVector<QRect>& rects = m_segmentRects.at(i);
+        if(rects.isEmpty())
+        {
+            continue;
+        }
+        if (m_stats)
+        {
+            m_stats->itemsDrawn += rects.size();
+        }
+        const SegmentPalette& palette = m_palette.at(i);
+        painter->setPen(palette.pen);
+        painter->setBrush(palette.brush);
+        painter->drawRects(rects.constData(), rects.size());
+    }
+}
+
+void MultiSliderPrivate::drawLevelOfDetail(QStylePainter* painter, int from, int to)
+{
+    Q_Q(MultiSlider);
+    const Geometry& g = geometry();
+    const bool horizontal = g.orientation == Qt::Horizontal;
+    const int length = horizontal ? g.handle.width() : g.handle.height();
+    const int count = m_model.count();
+    const auto handleStart = [this, &g](int index) {
+        return pixelPosFromRangeValue(m_model.position(index)) + g.handleOffset;
+    };
+    const auto center = [&](int index) {
+        return handleStart(index) + length / 2;
+    };
+    // count of handles which centers are before given pixel
+    const auto handlesBefore = [&](int pixel) {
+        return g.upsideDown
+                ? PartitionPoint(0, count, [&](int i) { return center(i) > pixel; })
+                : PartitionPoint(0, count, [&](int i) { return center(i) < pixel; });
+    };
+    // rect across the slider at given pixel, thickness is taken from given rect
+    const auto column = [horizontal](int pixel, const QRect& rect) {
+        return horizontal ? QRect(pixel, rect.top(), 1, rect.height())
+                          : QRect(rect.left(), pixel, rect.width(), 1);
+    };
+    const QRect segmentThickness = horizontal
+            ? QRect(QPoint(0, g.groove.center().y() - 2), QPoint(0, g.groove.center().y() + 1))
+            : QRect(QPoint(g.groove.center().x() - 2, 0), QPoint(g.groove.center().x() + 1, 0));
+
+    // Each pixel shows the segment it starts with and a mark which darkness
+    // depends on count of handles inside the pixel
+    static const int DensityLevels = 4;
+    QVector<QRect> marks[DensityLevels];
+    clearSegments();
+    int lastSegment = -1;
+    for(int pixel = from; pixel <= to; ++pixel)
+    {
+        const int segment = handlesBefore(pixel);
+        const int handles = (g.upsideDown ? handlesBefore(pixel - 1) : handlesBefore(pixel + 1)) - segment;
+        QVector<QRect>& rects = segmentsOfColor(segmentColorIndex(segment));
+        if(segment == lastSegment)
+        {
+            rects.last() |= column(pixel, segmentThickness);
+        }
+        else
+        {
+            rects.append(column(pixel, segmentThickness));
+        }
+        lastSegment = segment;
+        if(handles > 1)
+        {
+            int level = 0;
+            while(level < DensityLevels - 1 && (handles >> (level + 1)) > 1)
+            {
+                ++level;
+            }
+            marks[level].append(column(pixel, g.handle));
+        }
+    }
+    drawSegments(painter);
+
+    painter->setPen(Qt::NoPen);
+    QColor markColor = q->palette().color(QPalette::WindowText);
+    for(int level = 0; level < DensityLevels; ++level)
+    {
+        if(!marks[level].isEmpty())
+        {
+            markColor.setAlpha(64 + 48 * level);
+            painter->setBrush(markColor);
+            painter->drawRects(marks[level].constData(), marks[level].size());
+        }
+    }
+
+    // handles are drawn only where they do not overlap already drawn ones
+    int i = 0;
+    if(g.upsideDown)
+    {
+        int limit = to;
+        while((i = PartitionPoint(i, count, [&](int index) { return handleStart(index) > limit; })) != count)
+        {
+            const int start = handleStart(i);
+            if(start + length - 1 < from)
+            {
+                break;
+            }
+            drawHandle(i, painter);
+            limit = start - length;
+            ++i;
+        }
+    }
+    else
+    {
+        int limit = from - length + 1;
+        while((i = PartitionPoint(i, count, [&](int index) { return handleStart(index) < limit; })) != count)
+        {
+            const int start = handleStart(i);
+            if(start > to)
+            {
+                break;
+            }
+            drawHandle(i, painter);
+            limit = start + length;
+            ++i;
+        }
+    }
+    for(int selected : m_selectedHandles)
+    {
+        drawHandle(selected, painter);
+    }
+}
+
+MultiSlider::MultiSlider(QWidget* _parent)
+    : QSlider(_parent)
+    , d_ptr(new MultiSliderPrivate(*this))
+{
+    Q_D(MultiSlider);
+    d->init();
+}
+
+MultiSlider::~MultiSlider()
+{
+}
+
+QColor MultiSlider::color(int index, double bright)
+{
+    return QColor::fromHslF((index % ColorsCount) * 1.0 / ColorsCount, 1, bright);
+}
+
+QVector<QColor> MultiSlider::colorScheme() const
+{
+    Q_D(const MultiSlider);
+    return d->m_colorScheme;
+}
+
+void MultiSlider::setColorScheme(const QVector<QColor>& colors)
+{
+    Q_D(MultiSlider);
+    if (d->m_colorScheme == colors && !colors.isEmpty())
+    {
+        return;
+    }
+    d->setColorScheme(colors);
+    update();
+    emit colorSchemeChanged();
+}
+
+QColor MultiSlider::segmentColor(int index) const
+{
+    Q_D(const MultiSlider);
+    return d->m_colorScheme.at(index % d->m_colorScheme.size());
+}
+
+QColor MultiSlider::segmentBackgroundColor(int index) const
+{
+    Q_D(const MultiSlider);
+    return d->m_palette.at(index % d->m_palette.size()).background;
+}
+
+MultiSlider::MultiSlider( Qt::Orientation o,
+                                  QWidget* parentObject )
+    :QSlider(o, parentObject)
+    , d_ptr(new MultiSliderPrivate(*this))
+{
+    Q_D(MultiSlider);
+    d->init();
+}
+
+MultiSlider::MultiSlider(MultiSliderPrivate* impl, QWidget* _parent)
+    : QSlider(_parent)
+    , d_ptr(impl)
+{
+    Q_D(MultiSlider);
+    d->init();
+}
+
+MultiSlider::MultiSlider( MultiSliderPrivate* impl, Qt::Orientation o,
+                                QWidget* parentObject )
+    :QSlider(o, parentObject)
+    , d_ptr(impl)
+{
+    Q_D(MultiSlider);
+    d->init();
+}
+
+bool MultiSlider::isHandleDown(int index) const
+{
+    Q_D(const MultiSlider);
+    return d->m_selectedHandles.contains(index);
+}
+
+int MultiSlider::count() const
+{
+    Q_D(const MultiSlider);
+    return d->m_model.count();
+}
+
+int MultiSlider::minimumRange() const
+{
+    Q_D(const MultiSlider);
+    return d->m_model.minimumRange();
+}
+
+int MultiSlider::maxCount() const
+{
+    Q_D(const MultiSlider);
+    return d->m_model.maxCount();
+}
+
+void MultiSlider::setCount(int arg)
+{
+    Q_ASSERT(arg >= 0);
+    Q_ASSERT(arg < maxCount());
+    const int count = this->count();
+    if (count == arg)
+    {
+        return;
+    }
+    if(arg > count)
+    {
+        addToRight(arg - count);
+    }
+    else
+    {
+        removeFromRight(count - arg);
+    }
+}
+
+void MultiSlider::setMinimumRange(int arg)
+{
+    Q_D(MultiSlider);
+    if (d->m_model.minimumRange() == arg)
+    {
+        return;
+    }
+
+    d->m_model.setMinimumRange(arg);
+    refreshMaxCount();
+    normalize(true);
+    clearUndoHistory();
+    emit minimumRangeChanged(arg);
+    update();
+}
+
+void MultiSlider::refreshMaxCount()
+{
+    Q_D(MultiSlider);
+    if(d->m_model.refreshMaxCount())
+    {
+        if(count() > maxCount())
+        {
+            setCount(maxCount());
+        }
+        emit maxCountChanged(maxCount());
+    }
+}
+
+void MultiSlider::addOneToleft()
+{
+    addToLeft(1);
+}
+
+void MultiSlider::addToLeft(int arg)
+{
+    Q_D(MultiSlider);
+    if(d->m_model.addToLeft(arg))
+    {
+        onCountChanged();
+    }
+}
+
+void MultiSlider::addOneToRight()
+{
+    addToRight(1);
+}
+
+void MultiSlider::addToRight(int arg)
+{
+    Q_D(MultiSlider);
+    if(d->m_model.addToRight(arg))
+    {
+        onCountChanged();
+    }
+}
+
+void MultiSlider::removeOneFromLeft()
+{
+    removeFromLeft(1);
+}
+
+void MultiSlider::removeFromLeft(int count)
+{
+    count = qMin(this->count(), count);
+    if(count <= 0)
+    {
+        return;
+    }
+    removePositions(0, count);
+    onCountChanged();
+}
+
+void MultiSlider::removeOneFromRight()
+{
+    removeFromRight(1);
+}
+
+void MultiSlider::removeFromRight(int count)
+{
+    count = qMin(this->count(), count);
+    if(count <= 0)
+    {
+        return;
+    }
+    removePositions(this->count() - count, count);
+    onCountChanged();
+}
+
+void MultiSlider::insertHandles(int index, int count)
+{
+    Q_D(MultiSlider);
+    if(d->m_model.insertHandles(index, count))
+    {
+        onCountChanged();
+    }
+}
+
+void MultiSlider::removeHandles(int index, int count)
+{
+    Q_ASSERT(index >= 0);
+    Q_ASSERT(index <= this->count());
+    count = qMin(count, this->count() - index);
+    if(count <= 0)
+    {
+        return;
+    }
+    removePositions(index, count);
+    onCountChanged();
+}
+
+void MultiSlider::removePositions(int index, int count)
+{
+    Q_D(MultiSlider);
+    d->m_model.removePositions(index, count);
+    // selected handles after removed ones are not the same handles anymore
+    for(int handle : d->m_selectedHandles)
+    {
+        if(handle >= index)
+        {
+            d->m_selectedHandles.clear();
+            break;
+        }
+    }
+}
+
+void MultiSlider::onCountChanged()
+{
+    Q_D(MultiSlider);
+    emit countChanged(count());
+    normalize(true);
+    if(hasTracking())
+    {
+        // handles moved to free the space for new ones
+        commitValues();
+    }
+    if (d->m_snapshot)
+    {
+        d->m_snapshot->publish(d->m_model.values().constData(), d->m_model.count());
+    }
+    // recorded indices are shifted
+    clearUndoHistory();
+    // vectors of positions and values have new size even if no handle moved
+    emit positionsUpdated();
+    emit valuesUpdated();
+    update();
+}
+
+QVector<int> MultiSlider::values() const
+{
+    Q_D(const MultiSlider);
+    return HandlesVector(d->m_model.values());
+}
+
+QVector<int> MultiSlider::positions() const
+{
+    Q_D(const MultiSlider);
+    return HandlesVector(d->m_model.positions());
+}
+
+int MultiSlider::position(int index) const
+{
+    Q_D(const MultiSlider);
+    return d->m_model.position(index);
+}
+
+int MultiSlider::value(int index) const
+{
+    Q_D(const MultiSlider);
+    return d->m_model.value(index);
+}
+
+const MultiSliderModel& MultiSlider::model() const
+{
+    Q_D(const MultiSlider);
+    return d->m_model;
+}
+
+MultiSliderSnapshot* MultiSlider::valuesSnapshot()
+{
+    Q_D(MultiSlider);
+    if (!d->m_snapshot)
+    {
+        d->m_snapshot.reset(new MultiSliderSnapshot);
+        d->m_snapshot->publish(d->m_model.values().constData(), d->m_model.count());
+    }
+    return d->m_snapshot.data();
+}
+
+void MultiSlider::setPosition(int index, int arg)
+{
+    placePosition(index, snapPosition(index, arg));
+}
+
+void MultiSlider::stepPosition(int index, int delta)
+{
+    Q_D(MultiSlider);
+    if (!delta)
+    {
+        return;
+    }
+    const qint64 arg = qBound<qint64>(minimum(), qint64(d->m_model.position(index)) + delta, maximum());
+    placePosition(index, snapPosition(index, int(arg), delta));
+}
+
+void MultiSlider::placePosition(int index, int arg)
+{
+    Q_D(MultiSlider);
+    Q_ASSERT(index >= 0);
+    Q_ASSERT(index <= count());
+    if (d->m_transactionDepth)
+    {
+        d->m_model.stagePosition(index, arg);
+        return;
+    }
+    if (d->m_model.position(index) != arg)
+    {
+        const QPair<int, int> moved = d->m_model.movePosition(index, arg - d->m_model.position(index));
+        if (d->m_stats)
+        {
+            ++d->m_stats->solverCalls;
+            d->m_stats->cascadeHandles += moved.second - moved.first;
+            d->m_stats->maxCascadeDepth = qMax(d->m_stats->maxCascadeDepth, moved.second - moved.first);
+        }
+        if (moved.first == moved.second)
+        {
+            return;
+        }
+        notifyPositionsChanged(moved.first, moved.second);
+        if (hasTracking())
+        {
+            commitValues();
+        }
+    }
+}
+
+void MultiSlider::setValue(int index, int arg)
+{
+    Q_D(MultiSlider);
+    Q_ASSERT(index >= 0);
+    Q_ASSERT(index <= count());
+    if (d->m_transactionDepth)
+    {
+        // snapped like setPosition does outside transaction
+        d->m_model.stagePosition(index, snapPosition(index, arg));
+        d->m_transactionValues = true;
+        return;
+    }
+    if (d->m_model.value(index) != arg)
+    {
+        setPosition(index, arg);
+        commitValues();
+    }
+}
+
+void MultiSlider::shiftValues(int first, int last, int delta)
+{
+    Q_D(MultiSlider);
+    if (d->m_transactionDepth)
+    {
+        for (int i = first; i < last; ++i)
+        {
+            d->m_model.stagePosition(i, d->m_model.position(i) + delta);
+        }
+        d->m_transactionValues = true;
+        return;
+    }
+    // pending values are committed by their own signals, so shift signals report the shift only
+    commitValues();
+    delta = d->m_model.shiftHandles(first, last, delta);
+    if (delta == 0)
+    {
+        return;
+    }
+    d->updateHandles(first, last);
+    if (d->m_snapshot)
+    {
+        d->m_snapshot->publish(d->m_model.values().constData(), d->m_model.count());
+    }
+    if (d->m_journal && !d->m_applyingJournal)
+    {
+        d->m_journal->recordShift(first, last, delta);
+    }
+    emit positionsShifted(first, last, delta);
+    if (d->m_fullVectorSignals)
+    {
+        emit positionsChanged(HandlesVector(d->m_model.positions()));
+    }
+    emit positionsUpdated();
+    emit valuesShifted(first, last, delta);
+    if (d->m_fullVectorSignals)
+    {
+        emit valuesChanged(HandlesVector(d->m_model.values()));
+    }
+    emit valuesUpdated();
+    if (d->m_stats)
+    {
+        d->m_stats->positionsSignals += d->m_fullVectorSignals ? 2 : 1;
+        d->m_stats->valuesSignals += d->m_fullVectorSignals ? 2 : 1;
+    }
+}
+
+void MultiSlider::setValues(QVector<int> values)
+{
+    Q_D(MultiSlider);
+    Q_ASSERT(values.size() == this->count());
+    if (d->m_transactionDepth)
+    {
+        for (int i = 0; i < values.size(); ++i)
+        {
+            d->m_model.stagePosition(i, values.at(i));
+        }
+        d->m_transactionValues = true;
+        return;
+    }
+    if (!std::equal(values.constBegin(), values.constEnd(), d->m_model.values().constBegin()))
+    {
+        const QPair<int, int> moved = d->m_model.setPositions(values);
+        if (moved.first < moved.second)
+        {
+            notifyPositionsChanged(moved.first, moved.second);
+        }
+        d->m_model.markUncommitted(0, count());
+        commitValues();
+    }
+}
+
+void MultiSlider::beginTransaction(bool recordUndo)
+{
+    Q_D(MultiSlider);
+    if (d->m_transactionDepth++ == 0)
+    {
+        d->m_model.beginStaging();
+    }
+    if (!recordUndo)
+    {
+        d->m_transactionWithoutUndo = true;
+    }
+}
+
+void MultiSlider::commitTransaction()
+{
+    Q_D(MultiSlider);
+    Q_ASSERT(d->m_transactionDepth > 0);
+    if (--d->m_transactionDepth)
+    {
+        return;
+    }
+    const QPair<int, int> moved = d->m_model.endStaging();
+    if (moved.first < moved.second)
+    {
+        notifyPositionsChanged(moved.first, moved.second);
+    }
+    if (d->m_transactionValues || hasTracking())
+    {
+        commitValues();
+    }
+    d->m_transactionValues = false;
+    d->m_transactionWithoutUndo = false;
+}
+
+int MultiSlider::undoLimit() const
+{
+    Q_D(const MultiSlider);
+    return d->m_journal ? d->m_journal->limit() : 0;
+}
+
+void MultiSlider::setUndoLimit(int bytes)
+{
+    Q_D(MultiSlider);
+    if (bytes <= 0)
+    {
+        d->m_journal.reset();
+    }
+    else if (d->m_journal)
+    {
+        d->m_journal->setLimit(bytes);
+    }
+    else
+    {
+        d->m_journal.reset(new MultiSliderJournal(bytes));
+    }
+}
+
+bool MultiSlider::canUndo() const
+{
+    Q_D(const MultiSlider);
+    return d->m_journal && d->m_journal->canUndo();
+}
+
+bool MultiSlider::canRedo() const
+{
+    Q_D(const MultiSlider);
+    return d->m_journal && d->m_journal->canRedo();
+}
+
+void MultiSlider::undo()
+{
+    Q_D(MultiSlider);
+    if (!canUndo() || d->m_transactionDepth)
+    {
+        return;
+    }
+    const MultiSliderJournal::Entry& entry = d->m_journal->undo();
+    if (entry.shift)
+    {
+        applyJournalShift(entry.first, entry.last, -entry.shift);
+        return;
+    }
+    applyJournal(entry.first, entry.oldValues);
+}
+
+void MultiSlider::redo()
+{
+    Q_D(MultiSlider);
+    if (!canRedo() || d->m_transactionDepth)
+    {
+        return;
+    }
+    const MultiSliderJournal::Entry& entry = d->m_journal->redo();
+    if (entry.shift)
+    {
+        applyJournalShift(entry.first, entry.last, entry.shift);
+        return;
+    }
+    applyJournal(entry.first, entry.newValues);
+}
+
+void MultiSlider::clearUndoHistory()
+{
+    Q_D(MultiSlider);
+    if (d->m_journal)
+    {
+        d->m_journal->clear();
+    }
+}
+
+void MultiSlider::applyJournal(int first, QVector<int> values)
+{
+    Q_D(MultiSlider);
+    Q_ASSERT(!d->m_transactionDepth);
+    // values were valid together with the values around them, so they are not normalized
+    d->m_applyingJournal = true;
+    const QPair<int, int> moved = d->m_model.replacePositions(first, values);
+    // marked before slots run, the model keeps the mark valid if they change count
+    d->m_model.markUncommitted(first, first + values.size());
+    if (moved.first < moved.second)
+    {
+        notifyPositionsChanged(moved.first, moved.second);
+    }
+    commitValues();
+    d->m_applyingJournal = false;
+}
+
+void MultiSlider::applyJournalShift(int first, int last, int delta)
+{
+    Q_D(MultiSlider);
+    Q_ASSERT(!d->m_transactionDepth);
+    // the block is shifted back from where the recorded shift left it, so delta is not cut
+    d->m_applyingJournal = true;
+    shiftValues(first, last, delta);
+    d->m_applyingJournal = false;
+}
+
+bool MultiSlider::isInTransaction() const
+{
+    Q_D(const MultiSlider);
+    return d->m_transactionDepth != 0;
+}
+
+bool MultiSlider::fullVectorSignals() const
+{
+    Q_D(const MultiSlider);
+    return d->m_fullVectorSignals;
+}
+
+void MultiSlider::setFullVectorSignals(bool arg)
+{
+    Q_D(MultiSlider);
+    d->m_fullVectorSignals = arg;
+}
+
+void MultiSlider::notifyPositionsChanged(int first, int last)
+{
+    Q_D(MultiSlider);
+    Q_ASSERT(d->m_model.previousPositions().size() == last - first);
+    d->updateHandles(first, last);
+    // slots can change the slider and overwrite old positions in the model and the signal buffer,
+    // so later slots get shared copies of them
+    const QVector<int> oldPositions = d->m_model.previousPositions();
+    CopyHandles(d->m_model.positions(), first, last, d->m_signalPositions);
+    const QVector<int> newPositions = d->m_signalPositions;
+    emit positionsRangeChanged(first, last, oldPositions, newPositions);
+    if (d->m_fullVectorSignals)
+    {
+        emit positionsChanged(HandlesVector(d->m_model.positions()));
+    }
+    emit positionsUpdated();
+    if (d->m_stats)
+    {
+        d->m_stats->positionsSignals += d->m_fullVectorSignals ? 2 : 1;
+    }
+}
+
+void MultiSlider::commitValues()
+{
+    Q_D(MultiSlider);
+    if (d->m_transactionDepth)
+    {
+        // values are committed by commitTransaction
+        return;
+    }
+    const QPair<int, int> changed = d->m_model.commitValues();
+    if (changed.first == changed.second)
+    {
+        return;
+    }
+    if (d->m_snapshot)
+    {
+        d->m_snapshot->publish(d->m_model.values().constData(), d->m_model.count());
+    }
+    if (d->m_journal && !d->m_applyingJournal)
+    {
+        if (d->m_transactionWithoutUndo)
+        {
+            // steps of history are valid only together with the values around them
+            d->m_journal->clear();
+        }
+        else
+        {
+            d->m_journal->record(changed.first, d->m_model.previousValues(), d->m_model.values().constData());
+        }
+    }
+    // shared copies, see notifyPositionsChanged
+    const QVector<int> oldValues = d->m_model.previousValues();
+    CopyHandles(d->m_model.values(), changed.first, changed.second, d->m_signalValues);
+    const QVector<int> newValues = d->m_signalValues;
+    emit valuesRangeChanged(changed.first, changed.second, oldValues, newValues);
+    if (d->m_fullVectorSignals)
+    {
+        emit valuesChanged(HandlesVector(d->m_model.values()));
+    }
+    emit valuesUpdated();
+    if (d->m_stats)
+    {
+        d->m_stats->valuesSignals += d->m_fullVectorSignals ? 2 : 1;
+    }
+}
+
+QPair<int, int> MultiSlider::normalize(bool emitIfChanged)
+{
+    Q_D(MultiSlider);
+    const QPair<int, int> moved = d->m_model.normalize();
+    if (d->m_stats)
+    {
+        ++d->m_stats->normalizeCalls;
+        d->m_stats->normalizeHandles += moved.second - moved.first;
+    }
+    // moves inside transaction are reported by commitTransaction
+    if (emitIfChanged && moved.first < moved.second && !d->m_transactionDepth)
+    {
+        notifyPositionsChanged(moved.first, moved.second);
+        if(hasTracking())
+        {
+            commitValues();
+        }
+    }
+    return moved;
+}
+
+// --------------------------------------------------------------------------
+void MultiSlider::onRangeChanged(int _minimum, int _maximum)
+{
+    Q_D(MultiSlider);
+    d->m_model.setRange(_minimum, _maximum);
+    normalize(true);
+    clearUndoHistory();
+}
+
+// --------------------------------------------------------------------------
+// Render
+void MultiSlider::paintEvent( QPaintEvent* ev )
+{
+    Q_D(MultiSlider);
+    const StatsTimer timer(d->m_stats ? &d->m_stats->paintNsecs : nullptr);
+    if (d->m_stats)
+    {
+        ++d->m_stats->paintEvents;
+    }
+    QStyleOptionSlider option;
+    this->initStyleOption(&option);
+    QStylePainter painter(this);
+    option.subControls = QStyle::SC_SliderGroove;
+    if(this->tickPosition() != NoTicks)
+    {
+        option.subControls |= QStyle::SC_SliderTickmarks;
+    }
+    // Move to minimum to not highlight the SliderGroove.
+    // On mac style, drawing just the slider groove also draws the handles,
+    // therefore we give a negative (outside of view) position.
+    option.sliderValue = this->minimum() - this->maximum();
+    option.sliderPosition = this->minimum() - this->maximum();
+    painter.drawComplexControl(QStyle::CC_Slider, option);
+
+    // draw only handles in exposed rect and segments around them
+    const QRect exposed = ev->rect();
+    const int from = orientation() == Qt::Horizontal ? exposed.left() : exposed.top();
+    const int to = orientation() == Qt::Horizontal ? exposed.right() : exposed.bottom();
+    const QPair<int, int> visible = d->handlesInSpan(from, to);
+
+    if (d->m_levelOfDetail && visible.second - visible.first > to - from + 1)
+    {
+        // some pixels hold several handles
+        d->drawLevelOfDetail(&painter, from, to);
+        return;
+    }
+
+    // segment i lies between handles i - 1 and i.
+    // Segments are collected by color and each color is drawn at once.
+    d->clearSegments();
+    for(int i = visible.first;  i <= visible.second; ++i)
+    {
+        int pos = i ? d->m_model.position(i - 1) : minimum();
+        int nextPos = i < count() ? d->m_model.position(i) : maximum();
+        d->segmentsOfColor(d->segmentColorIndex(i)).append(d->segmentRect(pos, nextPos));
+    }
+    d->drawSegments(&painter);
+
+    for(int i = visible.first;  i < visible.second; ++i)
+    {
+        d->drawHandle(i, &painter);
+    }
+}
+
+// --------------------------------------------------------------------------
+bool MultiSlider::statsEnabled() const
+{
+    Q_D(const MultiSlider);
+    return !d->m_stats.isNull();
+}
+
+// --------------------------------------------------------------------------
+void MultiSlider::setStatsEnabled(bool arg)
+{
+    Q_D(MultiSlider);
+    if (statsEnabled() == arg)
+    {
+        return;
+    }
+    if (arg)
+    {
+        d->m_stats.reset(new MultiSliderStats);
+        d->m_statsTimer.start(StatsLogInterval);
+    }
+    else
+    {
+        d->m_statsTimer.stop();
+        d->m_stats.reset();
+    }
+}
+
+// --------------------------------------------------------------------------
+MultiSliderStats MultiSlider::stats() const
+{
+    Q_D(const MultiSlider);
+    return d->m_stats ? *d->m_stats : MultiSliderStats();
+}
+
+// --------------------------------------------------------------------------
+void MultiSlider::resetStats()
+{
+    Q_D(MultiSlider);
+    if (d->m_stats)
+    {
+        *d->m_stats = MultiSliderStats();
+    }
+}
+
+// --------------------------------------------------------------------------
+void MultiSlider::logStats()
+{
+    Q_D(MultiSlider);
+    if (!d->m_stats || !multiSliderStats().isDebugEnabled())
+    {
+        return;
+    }
+    const MultiSliderStats& stats = *d->m_stats;
+    qCDebug(multiSliderStats).nospace()
+            << objectName() << ": "
+            << "solver " << stats.solverCalls << " calls, " << stats.cascadeHandles << " handles, max depth " << stats.maxCascadeDepth
+            << "; normalize " << stats.normalizeCalls << " calls, " << stats.normalizeHandles << " handles"
+            << "; signals " << stats.positionsSignals << " positions, " << stats.valuesSignals << " values"
+            << "; paint " << stats.paintEvents << " events, " << stats.paintNsecs / 1000 << " us, " << stats.itemsDrawn << " items"
+            << "; hit tests " << stats.hitTests << ", " << stats.hitTestNsecs / 1000 << " us";
+}
+
+// --------------------------------------------------------------------------
+bool MultiSlider::levelOfDetail() const
+{
+    Q_D(const MultiSlider);
+    return d->m_levelOfDetail;
+}
+
+// --------------------------------------------------------------------------
+void MultiSlider::setLevelOfDetail(bool arg)
+{
+    Q_D(MultiSlider);
+    if (d->m_levelOfDetail == arg)
+    {
+        return;
+    }
+    d->m_levelOfDetail = arg;
+    update();
+}
+
+// --------------------------------------------------------------------------
+bool MultiSlider::snapToTicks() const
+{
+    Q_D(const MultiSlider);
+    return d->m_snapToTicks;
+}
+
+void MultiSlider::setSnapToTicks(bool arg)
+{
+    Q_D(MultiSlider);
+    d->m_snapToTicks = arg;
+}
+
+int MultiSlider::snapGrid() const
+{
+    Q_D(const MultiSlider);
+    return d->m_snapGrid;
+}
+
+void MultiSlider::setSnapGrid(int arg)
+{
+    Q_D(MultiSlider);
+    d->m_snapGrid = qMax(0, arg);
+}
+
+const QVector<int>& MultiSlider::snapMarkers() const
+{
+    Q_D(const MultiSlider);
+    return d->m_snapIndex.markers();
+}
+
+void MultiSlider::setSnapMarkers(const QVector<int>& markers)
+{
+    Q_D(MultiSlider);
+    d->m_snapIndex.setMarkers(markers);
+}
+
+int MultiSlider::snapDistance() const
+{
+    Q_D(const MultiSlider);
+    return d->m_snapDistance;
+}
+
+void MultiSlider::setSnapDistance(int arg)
+{
+    Q_D(MultiSlider);
+    d->m_snapDistance = qMax(0, arg);
+}
+
+int MultiSlider::snapPosition(int index, int arg, int direction) const
+{
+    Q_D(const MultiSlider);
+    if (!d->m_snapToTicks && !d->m_snapGrid && d->m_snapIndex.markers().isEmpty())
+    {
+        return arg;
+    }
+    // handle can reach only positions which leave minimum range for all handles beside it
+    // and from both ends of the range, like the solver keeps it,
+    // so snapping there never makes the cascade clamp the handle off its target
+    const qint64 range = d->m_model.minimumRange();
+    qint64 low = minimum() + (index + 1) * range;
+    qint64 high = maximum() - (count() - index) * range;
+    if (d->m_snapDistance)
+    {
+        low = qMax(low, qint64(arg) - d->m_snapDistance);
+        high = qMin(high, qint64(arg) + d->m_snapDistance);
+    }
+    if (direction > 0)
+    {
+        low = qMax(low, qint64(arg));
+    }
+    else if (direction < 0)
+    {
+        high = qMin(high, qint64(arg));
+    }
+    if (low > high)
+    {
+        return arg;
+    }
+
+    int snapped = arg;
+    qint64 snappedDistance = std::numeric_limits<qint64>::max();
+    auto consider = [&](bool found, int target)
+    {
+        if (found && qAbs(qint64(target) - arg) < snappedDistance)
+        {
+            snapped = target;
+            snappedDistance = qAbs(qint64(target) - arg);
+        }
+    };
+    int target = 0;
+    if (d->m_snapToTicks)
+    {
+        consider(MultiSliderSnapIndex::nearestStep(minimum(), d->tickInterval(), arg, int(low), int(high), target), target);
+    }
+    if (d->m_snapGrid)
+    {
+        consider(MultiSliderSnapIndex::nearestStep(minimum(), d->m_snapGrid, arg, int(low), int(high), target), target);
+    }
+    consider(d->m_snapIndex.nearestMarker(arg, int(low), int(high), target), target);
+    return snapped;
+}
+
+// --------------------------------------------------------------------------
+// Standard Qt UI events
+void MultiSlider::mousePressEvent(QMouseEvent* mouseEvent)
+{
+    Q_D(MultiSlider);
+    if (minimum() == maximum() || (mouseEvent->buttons() ^ mouseEvent->button()))
+    {
+        mouseEvent->ignore();
+        return;
+    }
+    int mepos = this->orientation() == Qt::Horizontal ? mouseEvent->pos().x() : mouseEvent->pos().y();
+
+    QRect handleRect;
+    int handle = d->handleAtPos(mouseEvent->pos(), handleRect);
+
+    if (handle != -1)
+    {
+        d->m_subclassPosition = d->m_model.position(handle);
+
+        // save the position of the mouse inside the handle for later
+        d->m_subclassClickOffset = mepos - (this->orientation() == Qt::Horizontal ?
+            handleRect.left() : handleRect.top());
+
+        if (d->m_journal)
+        {
+            // one drag is one undo step
+            d->m_journal->beginMerge();
+        }
+        this->setSliderDown(true);
+        selectHandle(handle);
+
+        // Accept the mouseEvent
+        mouseEvent->accept();
+        return;
+    }
+
+  // if we are here, no handles have been pressed
+  // Check if we pressed on the groove between the 2 handles
+  
+    QStyleOptionSlider option;
+    this->initStyleOption( &option );
+    QStyle::SubControl control = this->style()->hitTestComplexControl(QStyle::CC_Slider, &option, mouseEvent->pos(), this);
+
+    int index = d->posBetweenHandles(mouseEvent->pos());
+    if (control == QStyle::SC_SliderGroove && -1 != index)
+    {
+        // warning lost of precision it might be fatal
+        d->m_subclassPosition = (d->m_model.position(index) + d->m_model.position(index + 1)) / 2.;
+        d->m_subclassClickOffset = mepos - d->pixelPosFromRangeValue(d->m_subclassPosition);
+        d->m_subclassWidth = (d->m_model.position(index + 1) - d->m_model.position(index)) / 2.;
+        if (d->m_journal)
+        {
+            // one drag is one undo step
+            d->m_journal->beginMerge();
+        }
+        this->setSliderDown(true);
+        if (!this->isHandleDown(index) || !this->isHandleDown(index + 1))
+        {
+            d->m_selectedHandles.clear();
+            selectTwoHandles(index, index + 1);
+        }
+        mouseEvent->accept();
+        return;
+    }
+    mouseEvent->ignore();
+}
+
+int MultiSlider::selectedHandle() const
+{
+    Q_D(const MultiSlider);
+    return d->m_selectedHandles.isEmpty() ? -1 : d->m_selectedHandles.first();
+}
+
+void MultiSlider::selectHandle(int handle)
+{
+    Q_D(MultiSlider);
+    Q_ASSERT(handle >= 0);
+    Q_ASSERT(handle < count());
+    if (!d->m_selectedHandles.contains(handle))
+    {
+        for (int selected : d->m_selectedHandles)
+        {
+            d->updateHandle(selected);
+        }
+        d->m_selectedHandles.clear();
+        d->m_selectedHandles.push_back(handle);
+        d->updateHandle(handle);
+        emit selectedHandleChanged(handle);
+    }
+}
+
+void MultiSlider::selectTwoHandles(int firstHandle, int secondHandle)
+{
+    Q_D(MultiSlider);
+    Q_ASSERT(firstHandle >= 0 && secondHandle >= 1);
+    Q_ASSERT(firstHandle < count() - 1);
+    Q_ASSERT(secondHandle < count());
+    if (!d->m_selectedHandles.contains(firstHandle) || !d->m_selectedHandles.contains(secondHandle))
+    {
+        for (int selected : d->m_selectedHandles)
+        {
+            d->updateHandle(selected);
+        }
+        d->m_selectedHandles.clear();
+        d->m_selectedHandles.push_back(firstHandle);
+        d->m_selectedHandles.push_back(secondHandle);
+        d->updateHandle(firstHandle);
+        d->updateHandle(secondHandle);
+        emit selectedHandleChanged(firstHandle);
+    }
+}
+
+// --------------------------------------------------------------------------
+// Standard Qt UI events
+void MultiSlider::mouseMoveEvent(QMouseEvent* mouseEvent)
+{
+    Q_D(MultiSlider);
+    if (d->m_selectedHandles.isEmpty())
+    {
+        mouseEvent->ignore();
+        return;
+    }
+    int mepos = this->orientation() == Qt::Horizontal ?
+        mouseEvent->pos().x() : mouseEvent->pos().y();
+
+    if (d->m_dragCoalescing)
+    {
+        // only the latest pointer position is used once per frame
+        d->m_pendingDragPos = mepos;
+        d->m_dragPending = true;
+        if (!d->m_dragTimer.isActive())
+        {
+            d->m_dragTimer.start(frameInterval());
+        }
+    }
+    else
+    {
+        dragTo(mepos);
+    }
+    mouseEvent->accept();
+}
+
+// --------------------------------------------------------------------------
+void MultiSlider::dragTo(int mepos)
+{
+    Q_D(MultiSlider);
+    int newPosition = d->pixelPosToRangeValue(mepos - d->m_subclassClickOffset);
+
+    switch (d->m_selectedHandles.size())
+    {
+    case 1:
+        setPosition(d->m_selectedHandles.first(), newPosition);
+        break;
+    case 2:
+    {
+        // left handle snaps and right one keeps width of the segment
+        const int left = newPosition - static_cast<int>(d->m_subclassWidth);
+        const int shift = snapPosition(d->m_selectedHandles.at(0), left) - left;
+        placePosition(d->m_selectedHandles.at(0), left + shift);
+        placePosition(d->m_selectedHandles.at(1), newPosition + static_cast<int>(d->m_subclassWidth + .5) + shift);
+        break;
+    }
+    default:
+        Q_ASSERT(!"error selected handles count");
+        break;
+    }
+}
+
+// --------------------------------------------------------------------------
+void MultiSlider::flushPendingDrag()
+{
+    Q_D(MultiSlider);
+    d->m_dragTimer.stop();
+    if (d->m_dragPending)
+    {
+        d->m_dragPending = false;
+        if (!d->m_selectedHandles.isEmpty())
+        {
+            dragTo(d->m_pendingDragPos);
+        }
+    }
+}
+
+// --------------------------------------------------------------------------
+bool MultiSlider::dragCoalescing() const
+{
+    Q_D(const MultiSlider);
+    return d->m_dragCoalescing;
+}
+
+// --------------------------------------------------------------------------
+void MultiSlider::setDragCoalescing(bool arg)
+{
+    Q_D(MultiSlider);
+    if (d->m_dragCoalescing == arg)
+    {
+        return;
+    }
+    flushPendingDrag();
+    d->m_dragCoalescing = arg;
+}
+
+// --------------------------------------------------------------------------
+// Standard Qt UI mouseEvents
+void MultiSlider::mouseReleaseEvent(QMouseEvent* mouseEvent)
+{
+  Q_D(MultiSlider);
+  // release commits the exact final value
+  flushPendingDrag();
+  this->QSlider::mouseReleaseEvent(mouseEvent);
+
+  setSliderDown(false);
+  d->m_selectedHandles.clear();
+  commitValues();
+  if (d->m_journal)
+  {
+      d->m_journal->endMerge();
+  }
+  update();
+}
+
+// --------------------------------------------------------------------------
+void MultiSlider::initSliderStyleOption(int num, QStyleOptionSlider* option) const
+{
+    Q_UNUSED(num);
+    this->initStyleOption(option);
+}
+
+// --------------------------------------------------------------------------
+QString MultiSlider::handleToolTip()const
+{
+    Q_D(const MultiSlider);
+    return d->m_handleToolTip;
+}
+
+// --------------------------------------------------------------------------
+void MultiSlider::setHandleToolTip(const QString& _toolTip)
+{
+    Q_D(MultiSlider);
+    d->m_handleToolTip = _toolTip;
+}
+
+// --------------------------------------------------------------------------
+void MultiSlider::resizeEvent(QResizeEvent* ev)
+{
+    Q_D(MultiSlider);
+    d->invalidateGeometry();
+    this->Superclass::resizeEvent(ev);
+}
+
+// --------------------------------------------------------------------------
+void MultiSlider::changeEvent(QEvent* ev)
+{
+    Q_D(MultiSlider);
+    switch(ev->type())
+    {
+    case QEvent::StyleChange:
+        d->invalidateGeometry();
+        d->clearHandleSprites();
+        break;
+    case QEvent::LayoutDirectionChange:
+        d->invalidateGeometry();
+        break;
+    case QEvent::PaletteChange:
+        d->clearHandleSprites();
+        break;
+    default:
+        break;
+    }
+    this->Superclass::changeEvent(ev);
+}
+
+// --------------------------------------------------------------------------
+bool MultiSlider::event(QEvent* _event)
+{
+    Q_D(MultiSlider);
+    switch(_event->type())
+    {
+    case QEvent::ToolTip:
+    {
+        QHelpEvent* helpEvent = static_cast<QHelpEvent*>(_event);
+        QRect rect;
+        int handle = d->handleAtPos(helpEvent->pos(), rect);
+        if(handle != -1)
+        {
+            QToolTip::showText(helpEvent->globalPos(), d->m_handleToolTip.arg(d->m_model.position(handle)));
+            _event->accept();
+        }
+    }
+    default:
+        break;
+    }
+    return this->Superclass::event(_event);
+}
@@ -0,0 +1,498 @@
+#ifndef __MULTISLIDER_H__
+#define __MULTISLIDER_H__
+
+#include <QSlider>
+#include <QColor>
+#include <QVector>
+#include <QPair>
+
+#include "MultiSliderStats.h"
+
+class QStylePainter;
+class MultiSlider;
+
+class MultiSliderPrivate;
+class MultiSliderModel;
+class MultiSliderSnapshot;
+
+class  MultiSlider : public QSlider
+{
+    Q_OBJECT
+    Q_PROPERTY(QVector<int> values READ values WRITE setValues NOTIFY valuesUpdated)
+    Q_PROPERTY(QVector<int> positions READ positions NOTIFY positionsUpdated)
+    Q_PROPERTY(int minimumRange READ minimumRange WRITE setMinimumRange NOTIFY minimumRangeChanged)
+    Q_PROPERTY(QString handleToolTip READ handleToolTip WRITE setHandleToolTip)
+    Q_PROPERTY(int count READ count WRITE setCount NOTIFY countChanged)
+    Q_PROPERTY(int maxCount READ maxCount NOTIFY maxCountChanged)
+    Q_PROPERTY(int selectedHandle READ selectedHandle WRITE selectHandle NOTIFY selectedHandleChanged)
+    Q_PROPERTY(bool fullVectorSignals READ fullVectorSignals WRITE setFullVectorSignals)
+    Q_PROPERTY(bool dragCoalescing READ dragCoalescing WRITE setDragCoalescing)
+    Q_PROPERTY(bool levelOfDetail READ levelOfDetail WRITE setLevelOfDetail)
+    Q_PROPERTY(bool statsEnabled READ statsEnabled WRITE setStatsEnabled)
+    Q_PROPERTY(int undoLimit READ undoLimit WRITE setUndoLimit)
+    Q_PROPERTY(bool snapToTicks READ snapToTicks WRITE setSnapToTicks)
+    Q_PROPERTY(int snapGrid READ snapGrid WRITE setSnapGrid)
+    Q_PROPERTY(QVector<int> snapMarkers READ snapMarkers WRITE setSnapMarkers)
+    Q_PROPERTY(int snapDistance READ snapDistance WRITE setSnapDistance)
+
+public:
+    typedef QSlider Superclass;
+    static QColor color(int index, double bright);
+
+    /// \brief colors of segments, segment i has color i modulo count of colors
+    QVector<QColor> colorScheme() const;
+
+    /// \brief set colors of segments
+    /// \param colors  colors to cycle through, empty vector restores default colors
+    void setColorScheme(const QVector<QColor>& colors);
+
+    /// \brief color of segment at given index from the color scheme
+    QColor segmentColor(int index) const;
+
+    /// \brief light variant of segment color at given index, to be used as background
+    QColor segmentBackgroundColor(int index) const;
+
+    /// \brief Constructor, builds a MultiSlider with properties set the QSlider default properties.
+    explicit MultiSlider( Qt::Orientation o, QWidget* parent = nullptr );
+
+    /// \brief Constructor, builds a MultiSlider with properties set the QSlider default properties.
+    explicit MultiSlider( QWidget* par = nullptr );
+
+    ~MultiSlider();
+    /// \brief check that handle at given index is down
+    /// \param index    index of handle from left to right
+    /// \return handle selected state
+    bool isHandleDown(int index) const;
+
+    /// \brief holds the slider's current values.
+    /// \return slider current values for all handles.
+    QVector<int> values() const;
+
+    /// \brief holds the current slider positions.
+    /// \return slider current positions for all handles.
+    QVector<int> positions() const;
+
+    /// \brief position at given index.
+    int position(int index) const;
+
+    /// \brief value at given index.
+    int value(int index) const;
+
+    /// \brief positions, values and constraints of handles
+    /// \note the model is changed only through the slider, so it stays in sync with signals
+    const MultiSliderModel& model() const;
+
+    /// \brief latest committed values for a reader on another thread
+    /// \note snapshot is created on first call and then published on each values change
+    /// \note it can be read without locks by one thread while the slider exists
+    MultiSliderSnapshot* valuesSnapshot();
+
+    /// \brief return first selected handle
+    /// \return if handle was selected by mouse or by focus - return first of selected handles from left to right. Otherwise return -1.
+    int selectedHandle() const;
+
+    /// \brief set absolute position at given index
+    /// \note this function can change other positions
+    /// \note position is snapped if snapping is enabled
+    /// \note if tracking is enabled (the default), this is identical to setValue
+    /// \param index    number of handle from left to right
+    /// \param arg  absolute value of new position
+    void setPosition(int index, int arg);
+
+    /// \brief set absolute value at given index
+    /// \note this function can change other values
+    /// \note this function also will set position at given index
+    /// \note value is snapped if snapping is enabled, inside transaction too
+    /// \param index    number of handle from left to right
+    /// \param arg  absolute value of new value
+    void setValue(int index, int arg);
+
+    /// \brief move handle at given index by delta, as keyboard steps do
+    /// \note with snapping enabled the handle moves to the nearest snap target
+    /// at or beyond position + delta in direction of delta, so steps shorter than
+    /// distance between targets still move it
+    void stepPosition(int index, int delta);
+
+    /// \brief move handles [first, last) by delta keeping distances between them
+    /// \note delta is cut so the handles keep minimum range from their neighbours
+    /// \note this function also moves positions of these handles
+    /// \note outside transaction costs O(log count): the shift is reported by positionsShifted and valuesShifted
+    /// instead of range signals, and it is one undo step whatever count of shifted handles.
+    /// Full vector signals and values snapshot, if enabled, still cost O(count).
+    /// \note values are not snapped, inside transaction neither
+    /// \param first   index of first handle to move
+    /// \param last    index after last handle to move
+    /// \param delta   shift of values
+    void shiftValues(int first, int last, int delta);
+
+    /// \brief set absolute values
+    /// \note this function will override
+    /// \note this function also will change all positions
+    /// \note if values count must be equeal to slider count
+    /// \note values are not snapped, inside transaction neither
+    /// \param values  absolute values
+    void setValues(QVector<int> values);
+
+    /// \brief start batch of edits.
+    /// Until matching commitTransaction, setPosition, setValue, setValues and shiftValues
+    /// only stage new positions: they are not solved and no signals are emitted.
+    /// \note transactions can be nested, edits are applied by the outermost commit
+    /// \param recordUndo  false keeps the commit out of undo history, e.g. for automation.
+    /// Undo history is dropped if such commit changes values, as its steps assume the values around them.
+    /// The commit is not recorded if any nested level was begun without undo.
+    /// \see MultiSliderTransaction
+    void beginTransaction(bool recordUndo = true);
+
+    /// \brief apply staged edits.
+    /// Positions are normalized once, moved handles are reported by one positionsRangeChanged
+    /// and changed values by one valuesRangeChanged, and only moved handles are repainted.
+    /// \note staged positions are resolved by normalize, not by pushing neighbours one by one
+    void commitTransaction();
+
+    /// \brief check that edits are staged by transaction
+    bool isInTransaction() const;
+
+    /// \brief this property holds memory limit of undo history in bytes
+    /// \note 0 (the default) disables undo
+    int undoLimit() const;
+
+    /// \brief set memory limit of undo history, oldest steps are dropped to fit into it
+    /// \param bytes   memory limit, 0 disables undo and drops history
+    void setUndoLimit(int bytes);
+
+    /// \brief check that there is a step to undo
+    bool canUndo() const;
+
+    /// \brief check that there is an undone step to redo
+    bool canRedo() const;
+
+    /// \brief returns current tooltip
+    QString handleToolTip() const;
+    ///
+    /// \brief Controls the text to display for the handle tooltip. It is in addition to the widget tooltip.
+    /// \note "%1" is replaced by the current value of the slider.
+    /// \note Empty string (by default) means no tooltip.
+    void setHandleToolTip(const QString& toolTip);
+
+    /// \brief This property holds the current sliders count.
+    int count() const;
+
+    /// \brief this property holds minimum range between two slider handles
+    int minimumRange() const;
+
+    /// \brief this property holds maximum count of sliders
+    int maxCount() const;
+
+    /// \brief this property holds whether positionsChanged and valuesChanged are emitted
+    /// \note disabled by default, positionsRangeChanged and valuesRangeChanged are always emitted
+    /// \note notify signals of positions and values properties, positionsUpdated and valuesUpdated,
+    /// are always emitted too
+    bool fullVectorSignals() const;
+
+    /// \brief enable or disable positionsChanged and valuesChanged signals
+    void setFullVectorSignals(bool arg);
+
+    /// \brief refresh interval of the screen slider is shown on, in milliseconds
+    /// \note used to process mouse moves and key repeats once per frame
+    int frameInterval() const;
+
+    /// \brief this property holds whether mouse moves are processed once per screen frame
+    /// \note only the latest mouse position of the frame is used, release applies it immediately
+    /// \note disabled by default
+    bool dragCoalescing() const;
+
+    /// \brief enable or disable processing mouse moves once per screen frame
+    void setDragCoalescing(bool arg);
+
+    /// \brief this property holds whether crowded slider is drawn with level of detail.
+    /// \note when there are more handles than pixels, each pixel shows density of its handles
+    /// and only handles which do not overlap are drawn
+    /// \note enabled by default
+    bool levelOfDetail() const;
+
+    /// \brief enable or disable level of detail drawing
+    void setLevelOfDetail(bool arg);
+
+    /// \brief this property holds whether hot path counters are collected
+    /// \note while enabled, counters are written each second to "multislider.stats" debug logging category
+    /// \note disabled by default
+    bool statsEnabled() const;
+
+    /// \brief enable or disable hot path counters, enabling starts them from zero
+    void setStatsEnabled(bool arg);
+
+    /// \brief this property holds whether handles snap to tick marks
+    /// \note ticks are placed from minimum like QStyle draws them: by tickInterval, or by singleStep
+    /// if tickInterval is 0, or by pageStep if singleStep ticks would be closer than 3 pixels
+    /// \note disabled by default
+    bool snapToTicks() const;
+
+    /// \brief enable or disable snapping to tick marks
+    void setSnapToTicks(bool arg);
+
+    /// \brief this property holds step of snap grid placed from minimum
+    /// \note 0 (the default) disables snapping to grid
+    int snapGrid() const;
+
+    /// \brief set step of snap grid, 0 disables it
+    void setSnapGrid(int arg);
+
+    /// \brief this property holds sorted values handles snap to, like beat positions or data boundaries
+    const QVector<int>& snapMarkers() const;
+
+    /// \brief set values handles snap to, they are sorted and can be many
+    /// \note nearest marker is found by binary search
+    void setSnapMarkers(const QVector<int>& markers);
+
+    /// \brief this property holds maximum distance from handle to its snap target
+    /// \note 0 (the default) snaps to the nearest target at any distance
+    int snapDistance() const;
+
+    /// \brief set maximum distance from handle to its snap target
+    void setSnapDistance(int arg);
+
+    /// \brief counters collected since stats were enabled or reset
+    MultiSliderStats stats() const;
+
+    /// \brief start counters from zero
+    void resetStats();
+
+Q_SIGNALS:
+    ///
+    /// \brief This signal is emitted when the slider values has changed.
+    /// \param new slider values.
+    /// \note emitted only if fullVectorSignals is enabled
+    void valuesChanged(QVector<int> arg);
+
+    ///
+    /// \brief This signal is emitted when the slider moves.
+    /// \param new slider positions.
+    /// This signal is emitted even when tracking is turned off.
+    /// \note emitted only if fullVectorSignals is enabled
+    void positionsChanged(QVector<int> arg);
+
+    ///
+    /// \brief This signal is emitted once for each change of values, it is the notify signal of values property.
+    /// \note it has no arguments, so it is emitted whether fullVectorSignals is enabled or not
+    /// without copying values. Bindings read values property when they need it.
+    void valuesUpdated();
+
+    ///
+    /// \brief This signal is emitted once for each move of handles, it is the notify signal of positions property.
+    /// \note emitted whether fullVectorSignals is enabled or not, see valuesUpdated
+    void positionsUpdated();
+
+    ///
+    /// \brief This signal is emitted when values of handles [first, last) has changed.
+    /// \param oldValues  values of these handles before change
+    /// \param newValues  values of these handles after change
+    /// \note values changed by shiftValues outside transaction are reported by valuesShifted instead
+    void valuesRangeChanged(int first, int last, const QVector<int>& oldValues, const QVector<int>& newValues);
+
+    ///
+    /// \brief This signal is emitted when handles [first, last) moves.
+    /// \param oldPositions  positions of these handles before move
+    /// \param newPositions  positions of these handles after move
+    /// This signal is emitted even when tracking is turned off.
+    /// \note handles moved by shiftValues outside transaction are reported by positionsShifted instead
+    void positionsRangeChanged(int first, int last, const QVector<int>& oldPositions, const QVector<int>& newPositions);
+
+    ///
+    /// \brief This signal is emitted when shiftValues moved values of handles [first, last) by delta.
+    /// \note valuesRangeChanged is not emitted for such change, so its cost does not depend on count of handles
+    void valuesShifted(int first, int last, int delta);
+
+    ///
+    /// \brief This signal is emitted when shiftValues moved handles [first, last) by delta.
+    /// \note emitted before valuesShifted, positionsRangeChanged is not emitted for such move
+    void positionsShifted(int first, int last, int delta);
+
+    ///
+    /// \brief this signal is emitted when the sliders count changed
+    /// \param The argument is the new sliders count.
+    ///
+    void countChanged(int arg);
+
+    ///
+    /// \brief this signal is emitted whem minimum range between handles changed
+    /// \param The argument is the new value of minimum range between two handles.
+    ///
+    void minimumRangeChanged(uint arg);
+
+    ///
+    /// \brief this signal is emitted when maximum count of handles on slider changed
+    /// \param The argument is the new maximum count of slider handles
+    ///
+    void maxCountChanged(int arg);
+
+    ///
+    /// \brief this signal is emitted when new handle selected
+    /// \param The argument is the new maximum count of slider handles
+    ///
+    void selectedHandleChanged(int arg);
+
+    ///
+    /// \brief this signal is emitted when colors of segments changed
+    ///
+    void colorSchemeChanged();
+
+public Q_SLOTS:
+    /// \brief This property holds the slider's count.
+    /// \param argument is count to set.
+    /// \note arg wil be cutted to maximumCount value
+    void setCount(int arg);
+
+    /// \brief add handles to the left.
+    /// \param count    count of handles to be added
+    /// \note total count can not be more than maximumCount
+    void addToLeft(int count);
+
+    /// \brief add one handle to the left.
+    /// \note total count can not be more than maximumCount
+    void addOneToleft();
+
+    /// \brief add handles to the right.
+    /// \param count    count of handles to be added
+    /// \note total count can not be more than maximumCount
+    void addToRight(int count);
+
+    /// \brief add one handle to the right.
+    /// \note total count can not be more than maximumCount
+    void addOneToRight();
+
+    /// \brief remove handles from the left.
+    /// \param count    count of handles to be removed
+    void removeFromLeft(int count);
+
+    /// \brief remove one handle from the left.
+    void removeOneFromLeft();
+
+    /// \brief remove handles from the right.
+    /// \param count    count of handles to be removed
+    void removeFromRight(int count);
+
+    /// \brief remove one handle from the right.
+    void removeOneFromRight();
+
+    /// \brief insert handles before given index.
+    /// \param index    index of first new handle
+    /// \param count    count of handles to be added
+    /// \note new handles are evenly spaced between neighbours of given index
+    /// \note total count can not be more than maximumCount
+    void insertHandles(int index, int count);
+
+    /// \brief remove handles starting from given index.
+    /// \param index    index of first handle to be removed
+    /// \param count    count of handles to be removed
+    void removeHandles(int index, int count);
+
+    /// \brief this function will hold minimum range between two closest handles
+    /// \param arg  number of positions between thwo closest handles
+    void setMinimumRange(int arg);
+
+    /// \brief clear selection and mark given handle as selected
+    void selectHandle(int handle);
+
+    /// \brief clear selection and mark given handle as selected
+    void selectTwoHandles(int firstHandle, int secondHandle);
+
+    /// \brief restore values changed by the last step.
+    /// Each committed change of values is a step, changes of one mouse drag are one step.
+    /// \note history is cleared when count, range or minimum range changes
+    /// \note ignored inside transaction
+    void undo();
+
+    /// \brief apply the last undone step again
+    /// \note ignored inside transaction
+    void redo();
+
+    /// \brief drop undo history
+    void clearUndoHistory();
+
+protected Q_SLOTS:
+    /// \brief recalculate maximum count and cure extra handles from right
+    void refreshMaxCount();
+
+    /// \brief check that old positions not outside range
+    void onRangeChanged(int min, int max);
+
+    /// \brief apply mouse move delayed by dragCoalescing
+    void flushPendingDrag();
+
+    /// \brief write stats to "multislider.stats" logging category
+    void logStats();
+
+protected:
+    MultiSlider( MultiSliderPrivate* impl, Qt::Orientation o, QWidget* par = 0 );
+    MultiSlider( MultiSliderPrivate* impl, QWidget* par = 0 );
+
+    /// \brief normalize positions
+    /// \return range [first, second) of handles which were moved
+    QPair<int, int> normalize(bool emitIfChanged);
+
+    virtual void mousePressEvent(QMouseEvent* ev) override;
+    virtual void mouseMoveEvent(QMouseEvent* ev) override;
+    virtual void mouseReleaseEvent(QMouseEvent* ev) override;
+
+    virtual void paintEvent(QPaintEvent* ev) override;
+    virtual void initSliderStyleOption(int num, QStyleOptionSlider* option) const;
+
+    virtual void resizeEvent(QResizeEvent* ev) override;
+    virtual void changeEvent(QEvent* ev) override;
+
+    virtual bool event(QEvent* event) override;
+
+protected:
+    QScopedPointer<MultiSliderPrivate> d_ptr;
+
+private:
+    /// \brief move selected handles to given mouse position
+    void dragTo(int mepos);
+    /// \brief set position at given index without snapping
+    void placePosition(int index, int arg);
+    /// \brief nearest snap target for handle at given index which keeps minimum range
+    /// \param direction   if not 0, only targets at or beyond arg in its direction are used
+    /// \return arg if snapping is disabled or there is no target for this handle
+    int snapPosition(int index, int arg, int direction = 0) const;
+    /// \brief remove handles from the model and drop selection of shifted handles
+    void removePositions(int index, int count);
+    /// \brief emit countChanged, normalize and repaint after handles were added or removed
+    void onCountChanged();
+    /// \brief emit signals about moved handles [first, last), old positions are taken from the model
+    void notifyPositionsChanged(int first, int last);
+    /// \brief copy moved positions to values and emit signals about changed values
+    void commitValues();
+    /// \brief set values of handles starting from first, used by undo and redo
+    /// \note values are taken by value, slots can drop the journal entry they came from
+    void applyJournal(int first, QVector<int> values);
+    /// \brief shift values of handles [first, last), used by undo and redo of shiftValues
+    void applyJournalShift(int first, int last, int delta);
+
+    Q_DECLARE_PRIVATE(MultiSlider)
+    Q_DISABLE_COPY(MultiSlider)
+};
+
+/// Stages edits of MultiSlider during its lifetime, see MultiSlider::beginTransaction
+class MultiSliderTransaction
+{
+public:
+    /// \param recordUndo  see MultiSlider::beginTransaction
+    explicit MultiSliderTransaction(MultiSlider* slider, bool recordUndo = true)
+        : m_slider(slider)
+    {
+        m_slider->beginTransaction(recordUndo);
+    }
+
+    ~MultiSliderTransaction()
+    {
+        m_slider->commitTransaction();
+    }
+
+private:
+    MultiSlider* m_slider;
+
+    Q_DISABLE_COPY(MultiSliderTransaction)
+};
+
+#endif //__MULTISLIDER_H__
+
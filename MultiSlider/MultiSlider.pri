@@ -0,0 +1,15 @@
+# Link against MultiSlider static library.
+# Projects including this file are expected one level below the top directory.
+# Resources of the library must be initialized with Q_INIT_RESOURCE(res).
+
+INCLUDEPATH += $$PWD
+DEPENDPATH += $$PWD
+
+win32:CONFIG(release, debug|release): MULTISLIDER_LIB_DIR = $$OUT_PWD/../MultiSlider/release
+else:win32:CONFIG(debug, debug|release): MULTISLIDER_LIB_DIR = $$OUT_PWD/../MultiSlider/debug
+else: MULTISLIDER_LIB_DIR = $$OUT_PWD/../MultiSlider
+
+LIBS += -L$$MULTISLIDER_LIB_DIR -lMultiSlider
+
+win32:!win32-g++: PRE_TARGETDEPS += $$MULTISLIDER_LIB_DIR/MultiSlider.lib
+else: PRE_TARGETDEPS += $$MULTISLIDER_LIB_DIR/libMultiSlider.a
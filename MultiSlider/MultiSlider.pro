@@ -0,0 +1,37 @@
+#-------------------------------------------------
+#
+# MultiSlider static library, see MultiSlider.pri to link against it
+#
+#-------------------------------------------------
+
+QT       += core gui
+
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
+
+TARGET = MultiSlider
+TEMPLATE = lib
+CONFIG += staticlib
+
+SOURCES += MultiSlider.cpp \
+    MultiSliderWidget.cpp \
+    MultiSliderModel.cpp \
+    MultiSliderSnapshot.cpp \
+    MultiSliderJournal.cpp \
+    MultiSliderRecording.cpp \
+    MultiSliderAutomation.cpp \
+    MultiSliderSnapIndex.cpp
+
+HEADERS  += MultiSlider.h \
+    MultiSlider_p.h \
+    MultiSliderWidget.h \
+    MultiSliderModel.h \
+    MultiSliderSnapshot.h \
+    MultiSliderStats.h \
+    MultiSliderSolver.h \
+    MultiSliderJournal.h \
+    MultiSliderRecording.h \
+    MultiSliderAutomation.h \
+    MultiSliderSnapIndex.h
+
+RESOURCES += \
+    res.qrc
@@ -0,0 +1,185 @@
+#include <algorithm>
+
+#include "MultiSlider.h"
+#include "MultiSliderAutomation.h"
+
+MultiSliderAutomation::MultiSliderAutomation(MultiSlider* slider, QObject* parent)
+  : QObject(parent)
+  , m_slider(slider)
+  , m_duration(0)
+  , m_looping(false)
+  , m_time(0)
+  , m_startTime(0)
+{
+    Q_ASSERT(slider);
+    m_timer.setInterval(16);
+    m_timer.setTimerType(Qt::PreciseTimer);
+    connect(&m_timer, &QTimer::timeout, this, &MultiSliderAutomation::onTimer);
+}
+
+int MultiSliderAutomation::tickInterval() const
+{
+    return m_timer.interval();
+}
+
+void MultiSliderAutomation::setTickInterval(int msec)
+{
+    m_timer.setInterval(msec);
+}
+
+bool MultiSliderAutomation::looping() const
+{
+    return m_looping;
+}
+
+void MultiSliderAutomation::setLooping(bool arg)
+{
+    m_looping = arg;
+}
+
+int MultiSliderAutomation::duration() const
+{
+    return m_duration;
+}
+
+qint64 MultiSliderAutomation::time() const
+{
+    return m_time;
+}
+
+void MultiSliderAutomation::setTime(qint64 msec)
+{
+    m_time = msec;
+    if (isRunning())
+    {
+        m_startTime = msec;
+        m_clock.restart();
+    }
+    apply();
+}
+
+void MultiSliderAutomation::setCurve(int handle, const QVector<Keyframe>& keyframes)
+{
+    Q_ASSERT(handle >= 0);
+    Q_ASSERT(std::is_sorted(keyframes.constBegin(), keyframes.constEnd(),
+                            [](const Keyframe& a, const Keyframe& b) { return a.time < b.time; }));
+    auto it = std::lower_bound(m_curves.begin(), m_curves.end(), handle,
+                               [](const Curve& curve, int index) { return curve.handle < index; });
+    if (keyframes.isEmpty())
+    {
+        if (it != m_curves.end() && it->handle == handle)
+        {
+            m_curves.erase(it);
+        }
+    }
+    else if (it != m_curves.end() && it->handle == handle)
+    {
+        it->keyframes = keyframes;
+        it->cursor = 0;
+    }
+    else
+    {
+        Curve curve;
+        curve.handle = handle;
+        curve.keyframes = keyframes;
+        curve.cursor = 0;
+        m_curves.insert(it, curve);
+    }
+    m_duration = 0;
+    for (const Curve& curve : qAsConst(m_curves))
+    {
+        m_duration = qMax(m_duration, curve.keyframes.constLast().time);
+    }
+}
+
+void MultiSliderAutomation::clearCurves()
+{
+    m_curves.clear();
+    m_duration = 0;
+}
+
+bool MultiSliderAutomation::isRunning() const
+{
+    return m_timer.isActive();
+}
+
+void MultiSliderAutomation::start()
+{
+    if (isRunning())
+    {
+        return;
+    }
+    if (!m_looping && m_time >= m_duration)
+    {
+        m_time = 0;
+    }
+    m_startTime = m_time;
+    m_clock.start();
+    m_timer.start();
+    apply();
+}
+
+void MultiSliderAutomation::stop()
+{
+    m_timer.stop();
+}
+
+void MultiSliderAutomation::onTimer()
+{
+    // time follows the clock, so late ticks do not slow automation down
+    m_time = m_startTime + m_clock.elapsed();
+    const bool done = !m_looping && m_time >= m_duration;
+    if (done)
+    {
+        m_time = m_duration;
+        m_timer.stop();
+    }
+    apply();
+    if (done)
+    {
+        emit finished();
+    }
+}
+
+void MultiSliderAutomation::apply()
+{
+    if (!m_slider || m_curves.isEmpty())
+    {
+        return;
+    }
+    const qint64 time = m_looping && m_duration > 0 ? m_time % m_duration : m_time;
+    const int count = m_slider->count();
+    // ticks are not user edits, so they stay out of undo history
+    MultiSliderTransaction transaction(m_slider, false);
+    for (Curve& curve : m_curves)
+    {
+        if (curve.handle >= count)
+        {
+            break;
+        }
+        m_slider->setValue(curve.handle, evaluate(curve, time));
+    }
+}
+
+int MultiSliderAutomation::evaluate(Curve& curve, qint64 time)
+{
+    const QVector<Keyframe>& keyframes = curve.keyframes;
+    if (time < keyframes.at(curve.cursor).time)
+    {
+        // time went back, find the cursor again
+        auto it = std::upper_bound(keyframes.constBegin(), keyframes.constEnd(), time,
+                                   [](qint64 value, const Keyframe& keyframe) { return value < keyframe.time; });
+        curve.cursor = qMax(0, int(it - keyframes.constBegin()) - 1);
+    }
+    while (curve.cursor + 1 < keyframes.size() && keyframes.at(curve.cursor + 1).time <= time)
+    {
+        ++curve.cursor;
+    }
+    const Keyframe& from = keyframes.at(curve.cursor);
+    if (time <= from.time || curve.cursor + 1 == keyframes.size())
+    {
+        return from.value;
+    }
+    const Keyframe& to = keyframes.at(curve.cursor + 1);
+    return from.value + qRound(double(to.value - from.value) * (time - from.time) / (to.time - from.time));
+}
@@ -0,0 +1,111 @@
+#ifndef __MULTISLIDERAUTOMATION_H__
+#define __MULTISLIDERAUTOMATION_H__
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QPointer>
+#include <QTimer>
+#include <QVector>
+
+class MultiSlider;
+
+/// Moves MultiSlider handles along keyframe curves.
+/// On each tick all curves are evaluated at the current time and their values are set
+/// by one transaction, so positions are normalized once per tick and changed handles
+/// are reported by one range signal.
+/// \note ticks do not allocate once curves are set and slider buffers have grown
+class MultiSliderAutomation : public QObject
+{
+    Q_OBJECT
+
+public:
+    /// value of handle at given time, values between keyframes are interpolated linearly
+    struct Keyframe
+    {
+        /// milliseconds from the start of automation
+        int time;
+        int value;
+    };
+
+    explicit MultiSliderAutomation(MultiSlider* slider, QObject* parent = nullptr);
+
+    /// \brief this property holds interval between ticks in milliseconds
+    int tickInterval() const;
+
+    /// \brief set interval between ticks, 16 (the default) is about 60 ticks per second
+    void setTickInterval(int msec);
+
+    /// \brief this property holds whether automation starts over after the last keyframe
+    /// \note disabled by default
+    bool looping() const;
+
+    /// \brief enable or disable looping
+    void setLooping(bool arg);
+
+    /// \brief time of the last keyframe of all curves
+    int duration() const;
+
+    /// \brief current time in milliseconds
+    qint64 time() const;
+
+    /// \brief set current time and apply curves at it
+    void setTime(qint64 msec);
+
+    /// \brief set curve of handle at given index, handles without curves are not moved
+    /// \param keyframes    keyframes sorted by time, empty vector removes curve
+    /// \note curves of handles out of slider count are skipped
+    void setCurve(int handle, const QVector<Keyframe>& keyframes);
+
+    /// \brief remove all curves
+    void clearCurves();
+
+    /// \brief check that automation is running
+    bool isRunning() const;
+
+public slots:
+    /// \brief run automation from current time
+    void start();
+
+    /// \brief pause automation at current time
+    void stop();
+
+signals:
+    /// \brief this signal is emitted when not looping automation passes its last keyframe
+    void finished();
+
+private:
+    struct Curve
+    {
+        int handle;
+        QVector<Keyframe> keyframes;
+        /// index of the last keyframe not later than the last evaluated time
+        int cursor;
+    };
+
+    void onTimer();
+
+    /// \brief set values of all curves at current time
+    void apply();
+
+    /// \brief value of curve at given time
+    /// \note evaluation moves cursor of the curve, so monotonic time costs O(1) per tick
+    static int evaluate(Curve& curve, qint64 time);
+
+    QPointer<MultiSlider> m_slider;
+    QTimer m_timer;
+    QElapsedTimer m_clock;
+
+    /// curves sorted by handle
+    QVector<Curve> m_curves;
+
+    int m_duration;
+    bool m_looping;
+
+    /// current time and time when the clock was started
+    qint64 m_time;
+    qint64 m_startTime;
+};
+
+Q_DECLARE_TYPEINFO(MultiSliderAutomation::Keyframe, Q_PRIMITIVE_TYPE);
+
+#endif //__MULTISLIDERAUTOMATION_H__
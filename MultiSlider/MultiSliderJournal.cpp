@@ -0,0 +1,169 @@
+#include <algorithm>
+
+#include "MultiSliderJournal.h"
+
+MultiSliderJournal::MultiSliderJournal(int limit)
+    : m_undoCount(0)
+    , m_size(0)
+    , m_limit(limit)
+    , m_merging(false)
+    , m_mergeOpen(false)
+{
+}
+
+int MultiSliderJournal::limit() const
+{
+    return m_limit;
+}
+
+void MultiSliderJournal::setLimit(int limit)
+{
+    m_limit = limit;
+    trim();
+}
+
+int MultiSliderJournal::entrySize(const Entry& entry)
+{
+    return int(sizeof(Entry)) + (entry.oldValues.size() + entry.newValues.size()) * int(sizeof(int));
+}
+
+void MultiSliderJournal::record(int first, const QVector<int>& oldValues, const int* values)
+{
+    Q_ASSERT(first >= 0);
+    dropRedo();
+    if (m_mergeOpen)
+    {
+        merge(first, oldValues, values);
+        trim();
+        return;
+    }
+    Entry entry;
+    entry.first = first;
+    entry.oldValues = oldValues;
+    entry.newValues = QVector<int>(oldValues.size());
+    std::copy(values + first, values + first + oldValues.size(), entry.newValues.begin());
+    entry.last = first + oldValues.size();
+    entry.shift = 0;
+    append(entry);
+    m_mergeOpen = m_merging;
+}
+
+void MultiSliderJournal::recordShift(int first, int last, int delta)
+{
+    Q_ASSERT(first >= 0);
+    Q_ASSERT(first < last);
+    Q_ASSERT(delta != 0);
+    dropRedo();
+    Entry entry;
+    entry.first = first;
+    entry.last = last;
+    entry.shift = delta;
+    append(entry);
+    // values merged after the shift would be undone before it
+    m_mergeOpen = false;
+}
+
+void MultiSliderJournal::dropRedo()
+{
+    // redo history is not valid after new change
+    while (m_entries.size() > m_undoCount)
+    {
+        m_size -= entrySize(m_entries.last());
+        m_entries.removeLast();
+        m_mergeOpen = false;
+    }
+}
+
+void MultiSliderJournal::append(const Entry& entry)
+{
+    m_size += entrySize(entry);
+    m_entries.append(entry);
+    ++m_undoCount;
+    trim();
+}
+
+void MultiSliderJournal::merge(int first, const QVector<int>& oldValues, const int* values)
+{
+    Entry& entry = m_entries.last();
+    m_size -= entrySize(entry);
+    const int end = first + oldValues.size();
+    const int entryEnd = entry.first + entry.oldValues.size();
+    const int mergedFirst = qMin(first, entry.first);
+    const int mergedEnd = qMax(end, entryEnd);
+    // handles between the two ranges did not change since the merge started
+    QVector<int> mergedOld(mergedEnd - mergedFirst);
+    std::copy(values + mergedFirst, values + mergedEnd, mergedOld.begin());
+    std::copy(oldValues.constBegin(), oldValues.constEnd(), mergedOld.begin() + (first - mergedFirst));
+    std::copy(entry.oldValues.constBegin(), entry.oldValues.constEnd(), mergedOld.begin() + (entry.first - mergedFirst));
+    entry.first = mergedFirst;
+    entry.last = mergedEnd;
+    entry.newValues = QVector<int>(mergedOld.size());
+    std::copy(values + mergedFirst, values + mergedEnd, entry.newValues.begin());
+    entry.oldValues = mergedOld;
+    m_size += entrySize(entry);
+}
+
+void MultiSliderJournal::beginMerge()
+{
+    m_merging = true;
+    m_mergeOpen = false;
+}
+
+void MultiSliderJournal::endMerge()
+{
+    m_merging = false;
+    m_mergeOpen = false;
+}
+
+bool MultiSliderJournal::canUndo() const
+{
+    return m_undoCount > 0;
+}
+
+bool MultiSliderJournal::canRedo() const
+{
+    return m_undoCount < m_entries.size();
+}
+
+const MultiSliderJournal::Entry& MultiSliderJournal::undo()
+{
+    Q_ASSERT(canUndo());
+    m_mergeOpen = false;
+    return m_entries.at(--m_undoCount);
+}
+
+const MultiSliderJournal::Entry& MultiSliderJournal::redo()
+{
+    Q_ASSERT(canRedo());
+    m_mergeOpen = false;
+    return m_entries.at(m_undoCount++);
+}
+
+void MultiSliderJournal::clear()
+{
+    m_entries.clear();
+    m_undoCount = 0;
+    m_size = 0;
+    m_mergeOpen = false;
+}
+
+void MultiSliderJournal::trim()
+{
+    // the last entry is kept even if it alone does not fit, so the last change can be undone
+    while (m_size > m_limit && m_entries.size() > 1)
+    {
+        if (m_undoCount > 1)
+        {
+            m_size -= entrySize(m_entries.first());
+            m_entries.removeFirst();
+            --m_undoCount;
+        }
+        else
+        {
+            // redo entries can not be applied without the ones before them, so the farthest goes first
+            m_size -= entrySize(m_entries.last());
+            m_entries.removeLast();
+            m_mergeOpen = false;
+        }
+    }
+}
@@ -0,0 +1,92 @@
+#ifndef __MULTISLIDERJOURNAL_H__
+#define __MULTISLIDERJOURNAL_H__
+
+#include <QList>
+#include <QVector>
+
+/// Undo history of MultiSlider values.
+/// Each entry keeps only the changed range of handles with its old and new values,
+/// so undo and redo cost is proportional to the change, not to count of handles.
+/// Oldest entries are dropped when the journal exceeds its memory limit,
+/// the last change can be undone even if it alone exceeds the limit.
+class MultiSliderJournal
+{
+public:
+    /// values of handles [first, first + oldValues.size()) before and after change,
+    /// or shift of handles [first, last) if shift is not 0, then values are empty
+    struct Entry
+    {
+        int first;
+        QVector<int> oldValues;
+        QVector<int> newValues;
+        int last;
+        int shift;
+    };
+
+    /// \param limit    memory limit in bytes
+    explicit MultiSliderJournal(int limit);
+
+    int limit() const;
+
+    /// \brief set memory limit in bytes, oldest entries are dropped to fit into it
+    void setLimit(int limit);
+
+    /// \brief record changed values
+    /// \param first    index of first changed handle
+    /// \param oldValues    values of changed handles before change
+    /// \param values   all values after change
+    /// \note drops entries which can be redone
+    void record(int first, const QVector<int>& oldValues, const int* values);
+
+    /// \brief record shift of handles [first, last) by delta, it costs O(1) whatever count of handles
+    /// \note drops entries which can be redone, ends merge of the last entry
+    void recordShift(int first, int last, int delta);
+
+    /// \brief merge all changes recorded until endMerge into one entry
+    void beginMerge();
+
+    /// \brief stop merging changes, see beginMerge
+    void endMerge();
+
+    bool canUndo() const;
+    bool canRedo() const;
+
+    /// \brief step back, values of returned entry are to be replaced by its old values
+    const Entry& undo();
+
+    /// \brief step forward, values of returned entry are to be replaced by its new values
+    const Entry& redo();
+
+    /// \brief drop all entries
+    void clear();
+
+private:
+    /// \brief memory used by entry
+    static int entrySize(const Entry& entry);
+
+    /// \brief drop entries which can be redone
+    void dropRedo();
+
+    /// \brief append new entry and drop oldest ones if it does not fit
+    void append(const Entry& entry);
+
+    /// \brief merge change into the last entry
+    void merge(int first, const QVector<int>& oldValues, const int* values);
+
+    /// \brief drop oldest entries until journal fits into limit
+    /// \note the nearest undo entry (or redo entry if there is nothing to undo) is never dropped
+    void trim();
+
+    QList<Entry> m_entries;
+    /// entries before m_undoCount can be undone, the rest can be redone
+    int m_undoCount;
+    /// memory used by m_entries
+    int m_size;
+    int m_limit;
+    /// changes are merged into the last entry
+    bool m_merging;
+    /// the last entry was started by current merge
+    bool m_mergeOpen;
+};
+
+#endif //__MULTISLIDERJOURNAL_H__
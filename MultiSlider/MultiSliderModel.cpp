@@ -0,0 +1,502 @@
+#include <QtGlobal>
+
+#include <algorithm>
+#include <limits>
+
+#include "MultiSliderModel.h"
+#include "MultiSliderSolver.h"
+
+MultiSliderModel::MultiSliderModel()
+    : m_minimum(0)
+    , m_maximum(99)
+    , m_minimumRange(0)
+    , m_count(0)
+    , m_maxCount(0)
+    , m_shiftsPending(false)
+    , m_staging(false)
+    , m_uncommittedFirst(0)
+    , m_uncommittedEnd(0)
+{
+    refreshMaxCount();
+}
+
+int MultiSliderModel::minimum() const
+{
+    return m_minimum;
+}
+
+int MultiSliderModel::maximum() const
+{
+    return m_maximum;
+}
+
+void MultiSliderModel::setRange(int min, int max)
+{
+    m_minimum = min;
+    m_maximum = qMax(min, max);
+}
+
+int MultiSliderModel::minimumRange() const
+{
+    return m_minimumRange;
+}
+
+void MultiSliderModel::setMinimumRange(int arg)
+{
+    m_minimumRange = arg;
+}
+
+int MultiSliderModel::count() const
+{
+    return m_count;
+}
+
+int MultiSliderModel::maxCount() const
+{
+    return m_maxCount;
+}
+
+bool MultiSliderModel::refreshMaxCount()
+{
+    int newMaxCount = m_minimumRange ? ((m_maximum - m_minimum) / m_minimumRange - 1) : std::numeric_limits<int>::max(); //first position can be zero and we set margin as m_minimumRange
+    if(m_maxCount == newMaxCount)
+    {
+        return false;
+    }
+    m_maxCount = newMaxCount;
+    return true;
+}
+
+const MultiSliderModel::Handles& MultiSliderModel::positions() const
+{
+    applyShifts();
+    return m_positions;
+}
+
+const MultiSliderModel::Handles& MultiSliderModel::values() const
+{
+    applyShifts();
+    return m_values;
+}
+
+int MultiSliderModel::position(int index) const
+{
+    Q_ASSERT(index >= 0);
+    Q_ASSERT(index < m_count);
+    return m_shiftsPending ? int(m_positions.at(index) + pendingShift(index)) : m_positions.at(index);
+}
+
+int MultiSliderModel::value(int index) const
+{
+    Q_ASSERT(index >= 0);
+    Q_ASSERT(index < m_count);
+    return m_shiftsPending ? int(m_values.at(index) + pendingShift(index)) : m_values.at(index);
+}
+
+const QVector<int>& MultiSliderModel::previousPositions() const
+{
+    return m_previousPositions;
+}
+
+const QVector<int>& MultiSliderModel::previousValues() const
+{
+    return m_previousValues;
+}
+
+QPair<int, int> MultiSliderModel::movePosition(int index, int arg)
+{
+    Q_ASSERT(index >= 0);
+    Q_ASSERT(index < m_count);
+    applyShifts();
+    const MultiSliderSolver::Constraints constraints{ m_minimum, m_maximum, m_minimumRange };
+    const MultiSliderSolver::Cascade cascade = MultiSliderSolver::walkCascade(m_positions.constData(), m_count, index, arg, constraints);
+
+    // save walked positions for previousPositions()
+    const int walkedFirst = qMin(index, cascade.last);
+    const int walkedEnd = qMax(index, cascade.last) + 1;
+    QVector<int>& previous = m_previousPositions;
+    previous.resize(walkedEnd - walkedFirst);
+    std::copy(m_positions.constBegin() + walkedFirst, m_positions.constBegin() + walkedEnd, previous.begin());
+
+    int first = m_count;
+    int end = 0;
+    int* positions = m_positions.data();
+    MultiSliderSolver::placeCascade(positions, index, cascade, m_minimumRange, [positions, &first, &end](int i, int position) {
+        if(positions[i] != position)
+        {
+            positions[i] = position;
+            first = qMin(first, i);
+            end = qMax(end, i + 1);
+        }
+    });
+    if(first >= end)
+    {
+        previous.resize(0);
+        return qMakePair(index, index);
+    }
+    previous.remove(0, first - walkedFirst);
+    previous.resize(end - first);
+    markUncommitted(first, end);
+    return qMakePair(first, end);
+}
+
+QPair<int, int> MultiSliderModel::normalize()
+{
+    applyShifts();
+    QVector<int>& previous = m_previousPositions;
+    previous.resize(0);
+    if(m_count == 0)
+    {
+        return qMakePair(0, 0);
+    }
+    // Positions [saved, count) are copied to previous before the first write to any of them.
+    // Positions before saved are not changed yet, so they are copied at once when needed.
+    int saved = m_count;
+    int first = m_count;
+    int end = 0;
+    int* positions = m_positions.data();
+    const MultiSliderSolver::Constraints constraints{ m_minimum, m_maximum, m_minimumRange };
+    MultiSliderSolver::FixedCount<InlineCount>::normalize(positions, m_count, constraints, [this, positions, &previous, &saved, &first, &end](int i, int position) {
+        if(i < saved)
+        {
+            const int from = saved == m_count ? i : 0;
+            previous.insert(0, saved - from, 0);
+            std::copy(positions + from, positions + saved, previous.begin());
+            saved = from;
+        }
+        positions[i] = position;
+        first = qMin(first, i);
+        end = qMax(end, i + 1);
+    });
+    if(first >= end)
+    {
+        return qMakePair(0, 0);
+    }
+    previous.remove(0, first - saved);
+    previous.resize(end - first);
+    markUncommitted(first, end);
+    return qMakePair(first, end);
+}
+
+QPair<int, int> MultiSliderModel::setPositions(const QVector<int>& positions)
+{
+    Q_ASSERT(positions.size() == m_count);
+    applyShifts();
+    const Handles previous = m_positions;
+    std::copy(positions.constBegin(), positions.constEnd(), m_positions.begin());
+    normalize();
+    int first = 0;
+    int end = m_count;
+    while (first < end && previous.at(first) == m_positions.at(first))
+    {
+        ++first;
+    }
+    while (end > first && previous.at(end - 1) == m_positions.at(end - 1))
+    {
+        --end;
+    }
+    m_previousPositions.resize(end - first);
+    std::copy(previous.constBegin() + first, previous.constBegin() + end, m_previousPositions.begin());
+    markUncommitted(first, end);
+    return first < end ? qMakePair(first, end) : qMakePair(0, 0);
+}
+
+int MultiSliderModel::shiftHandles(int first, int last, int delta)
+{
+    Q_ASSERT(first >= 0);
+    Q_ASSERT(first <= last);
+    Q_ASSERT(last <= m_count);
+    Q_ASSERT(!m_staging);
+    if(first == last)
+    {
+        return 0;
+    }
+    // distances inside the block are kept, so only its edges are checked
+    // bounds can be out of int on the whole int range, delta bound by them is not
+    const qint64 low = qint64(first ? position(first - 1) : m_minimum) + m_minimumRange;
+    const qint64 high = qint64(last < m_count ? position(last) : m_maximum) - m_minimumRange;
+    delta = int(qBound(low - position(first), qint64(delta), high - position(last - 1)));
+    if(delta == 0)
+    {
+        return 0;
+    }
+    // positions and values move together, so uncommitted handles stay uncommitted
+    addShift(first, delta);
+    if(last < m_count)
+    {
+        addShift(last, -delta);
+    }
+    m_shiftsPending = true;
+    return delta;
+}
+
+QPair<int, int> MultiSliderModel::replacePositions(int first, const QVector<int>& positions)
+{
+    Q_ASSERT(first >= 0);
+    Q_ASSERT(first + positions.size() <= m_count);
+    applyShifts();
+    int begin = 0;
+    int end = positions.size();
+    while (begin < end && positions.at(begin) == m_positions.at(first + begin))
+    {
+        ++begin;
+    }
+    while (end > begin && positions.at(end - 1) == m_positions.at(first + end - 1))
+    {
+        --end;
+    }
+    m_previousPositions.resize(end - begin);
+    std::copy(m_positions.constBegin() + first + begin, m_positions.constBegin() + first + end, m_previousPositions.begin());
+    if (begin == end)
+    {
+        return qMakePair(0, 0);
+    }
+    std::copy(positions.constBegin() + begin, positions.constBegin() + end, m_positions.begin() + first + begin);
+    markUncommitted(first + begin, first + end);
+    return qMakePair(first + begin, first + end);
+}
+
+void MultiSliderModel::insertPositions(int index, int count, int first, int step)
+{
+    Q_ASSERT(index >= 0);
+    Q_ASSERT(index <= m_count);
+    Q_ASSERT(count >= 0);
+    applyShifts();
+    // one shift of the tail for all new handles
+    m_positions.insert(index, count, 0);
+    int* position = m_positions.data() + index;
+    for(int i = 0; i < count; ++i)
+    {
+        position[i] = first + i * step;
+    }
+    m_values.insert(index, count, 0);
+    std::copy(position, position + count, m_values.data() + index);
+    if(m_staging)
+    {
+        // new handles are not reported as moved
+        m_stagedFrom.insert(index, count, 0);
+        std::copy(position, position + count, m_stagedFrom.data() + index);
+    }
+    m_count += count;
+    m_shifts.resize(m_count);
+    std::fill(m_shifts.begin(), m_shifts.end(), 0);
+    if(m_uncommittedFirst < m_uncommittedEnd)
+    {
+        // uncommitted handles are shifted
+        m_uncommittedFirst = 0;
+        m_uncommittedEnd = m_count;
+    }
+}
+
+void MultiSliderModel::removePositions(int index, int count)
+{
+    Q_ASSERT(index >= 0);
+    Q_ASSERT(index + count <= m_count);
+    applyShifts();
+    m_positions.remove(index, count);
+    m_values.remove(index, count);
+    if(m_staging)
+    {
+        m_stagedFrom.remove(index, count);
+    }
+    m_count -= count;
+    // tree is all zeros after applyShifts
+    m_shifts.resize(m_count);
+    if(m_uncommittedFirst < m_uncommittedEnd)
+    {
+        // uncommitted handles are shifted
+        m_uncommittedFirst = 0;
+        m_uncommittedEnd = m_count;
+    }
+}
+
+int MultiSliderModel::spacing(int space) const
+{
+    return m_minimumRange ? m_minimumRange : space / 5;
+}
+
+int MultiSliderModel::addToLeft(int count)
+{
+    count = qMin(count, m_maxCount - m_count);
+    if(count <= 0)
+    {
+        return 0;
+    }
+    applyShifts();
+    int minDist = spacing(m_positions.isEmpty() ? m_maximum - m_minimum : m_positions.first() - m_minimum);
+    if(m_count && m_positions.first() - m_minimum < minDist * 2) //margin is min range
+    {
+        movePosition(0, count * minDist);
+    }
+    insertPositions(0, count, m_minimum + minDist, minDist);
+    return count;
+}
+
+int MultiSliderModel::addToRight(int count)
+{
+    count = qMin(count, m_maxCount - m_count);
+    if(count <= 0)
+    {
+        return 0;
+    }
+    applyShifts();
+    int minDist = spacing(m_positions.isEmpty() ? m_maximum - m_minimum : m_maximum - m_positions.last());
+    if(m_count && m_maximum - m_positions.last() < minDist * 2) //margin is min range
+    {
+        movePosition(m_count - 1, -1 * count * minDist);
+    }
+    int startPos = m_count != 0 ? (m_positions.last() + minDist) : m_minimum;
+    insertPositions(m_count, count, startPos, minDist);
+    return count;
+}
+
+int MultiSliderModel::insertHandles(int index, int count)
+{
+    Q_ASSERT(index >= 0);
+    Q_ASSERT(index <= m_count);
+    count = qMin(count, m_maxCount - m_count);
+    if(count <= 0)
+    {
+        return 0;
+    }
+    const int left = index ? position(index - 1) : m_minimum;
+    const int right = index < m_count ? position(index) : m_maximum;
+    const int step = (right - left) / (count + 1);
+    insertPositions(index, count, left + step, step);
+    return count;
+}
+
+void MultiSliderModel::beginStaging()
+{
+    Q_ASSERT(!m_staging);
+    applyShifts();
+    m_staging = true;
+    // copied into kept buffer instead of sharing, so repeated transactions do not allocate
+    m_stagedFrom.resize(m_positions.size());
+    std::copy(m_positions.constBegin(), m_positions.constEnd(), m_stagedFrom.begin());
+}
+
+bool MultiSliderModel::isStaging() const
+{
+    return m_staging;
+}
+
+void MultiSliderModel::stagePosition(int index, int position)
+{
+    Q_ASSERT(m_staging);
+    Q_ASSERT(index >= 0);
+    Q_ASSERT(index < m_count);
+    m_positions[index] = position;
+    markUncommitted(index, index + 1);
+}
+
+QPair<int, int> MultiSliderModel::endStaging()
+{
+    Q_ASSERT(m_staging);
+    m_staging = false;
+    normalize();
+    int first = 0;
+    int end = m_count;
+    while (first < end && m_stagedFrom.at(first) == m_positions.at(first))
+    {
+        ++first;
+    }
+    while (end > first && m_stagedFrom.at(end - 1) == m_positions.at(end - 1))
+    {
+        --end;
+    }
+    m_previousPositions.resize(end - first);
+    std::copy(m_stagedFrom.constBegin() + first, m_stagedFrom.constBegin() + end, m_previousPositions.begin());
+    markUncommitted(first, end);
+    return first < end ? qMakePair(first, end) : qMakePair(0, 0);
+}
+
+QPair<int, int> MultiSliderModel::commitValues()
+{
+    int first = m_uncommittedFirst;
+    int last = qMin(m_uncommittedEnd, m_count);
+    m_uncommittedFirst = m_uncommittedEnd = 0;
+    if (first < last)
+    {
+        applyShifts();
+    }
+    while (first < last && m_values.at(first) == m_positions.at(first))
+    {
+        ++first;
+    }
+    while (last > first && m_values.at(last - 1) == m_positions.at(last - 1))
+    {
+        --last;
+    }
+    m_previousValues.resize(last - first);
+    if (first == last)
+    {
+        return qMakePair(0, 0);
+    }
+    std::copy(m_values.constBegin() + first, m_values.constBegin() + last, m_previousValues.begin());
+    std::copy(m_positions.constBegin() + first, m_positions.constBegin() + last, m_values.begin() + first);
+    return qMakePair(first, last);
+}
+
+void MultiSliderModel::markUncommitted(int first, int last)
+{
+    if (first >= last)
+    {
+        return;
+    }
+    if (m_uncommittedFirst < m_uncommittedEnd)
+    {
+        m_uncommittedFirst = qMin(m_uncommittedFirst, first);
+        m_uncommittedEnd = qMax(m_uncommittedEnd, last);
+    }
+    else
+    {
+        m_uncommittedFirst = first;
+        m_uncommittedEnd = last;
+    }
+}
+
+qint64 MultiSliderModel::pendingShift(int index) const
+{
+    qint64 shift = 0;
+    for (int i = index + 1; i > 0; i -= i & -i)
+    {
+        shift += m_shifts.at(i - 1);
+    }
+    return shift;
+}
+
+void MultiSliderModel::addShift(int index, qint64 delta)
+{
+    for (int i = index + 1; i <= m_count; i += i & -i)
+    {
+        m_shifts[i - 1] += delta;
+    }
+}
+
+void MultiSliderModel::applyShifts() const
+{
+    if (!m_shiftsPending)
+    {
+        return;
+    }
+    m_shiftsPending = false;
+    qint64* tree = m_shifts.data();
+    // undo the tree build from the last node, so each node holds only its own difference of shifts
+    for (int i = m_count; i > 0; --i)
+    {
+        const int parent = i + (i & -i);
+        if (parent <= m_count)
+        {
+            tree[parent - 1] -= tree[i - 1];
+        }
+    }
+    qint64 shift = 0;
+    for (int i = 0; i < m_count; ++i)
+    {
+        shift += tree[i];
+        tree[i] = 0;
+        m_positions[i] = int(m_positions[i] + shift);
+        m_values[i] = int(m_values[i] + shift);
+    }
+}
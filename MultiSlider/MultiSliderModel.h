@@ -0,0 +1,195 @@
+#ifndef __MULTISLIDERMODEL_H__
+#define __MULTISLIDERMODEL_H__
+
+#include <QPair>
+#include <QVarLengthArray>
+#include <QVector>
+
+/// Positions and values of MultiSlider handles together with the constraint solver.
+/// Has no QWidget or QStyle dependencies, so it can be used without QApplication
+/// and from any thread (one thread at a time).
+/// All ranges returned by the model are half-open: [first, second).
+/// Positions and values of up to InlineCount handles are kept inside the model,
+/// so small sliders do not allocate them and their normalize is unrolled by compiler.
+/// Shifts of handle blocks are kept pending in a Fenwick tree, so a shift and reading
+/// a position or a value cost O(log count). Calls which need all positions apply them first.
+class MultiSliderModel
+{
+public:
+    /// count of handles kept inside the model, more handles are kept on the heap
+    enum { InlineCount = 8 };
+
+    /// positions or values of all handles
+    typedef QVarLengthArray<int, InlineCount> Handles;
+
+    MultiSliderModel();
+
+    /// \brief minimum available position
+    int minimum() const;
+
+    /// \brief maximum available position
+    int maximum() const;
+
+    /// \brief set range of positions
+    /// \note positions are not normalized, call normalize() after
+    void setRange(int min, int max);
+
+    /// \brief minimum range between two handles
+    int minimumRange() const;
+
+    /// \brief set minimum range between two handles
+    /// \note positions are not normalized, call refreshMaxCount() and normalize() after
+    void setMinimumRange(int arg);
+
+    /// \brief current count of handles
+    int count() const;
+
+    /// \brief maximum count of handles which fit into range with minimum range between them
+    int maxCount() const;
+
+    /// \brief recalculate maximum count
+    /// \return true if maximum count has changed
+    /// \note count is not cut, it is up to caller to remove extra handles
+    bool refreshMaxCount();
+
+    /// \brief positions of all handles
+    /// \note applies pending shifts
+    const Handles& positions() const;
+
+    /// \brief committed values of all handles
+    /// \note applies pending shifts
+    const Handles& values() const;
+
+    /// \brief position at given index.
+    /// \note O(log count) while shifts are pending, O(1) otherwise
+    int position(int index) const;
+
+    /// \brief value at given index.
+    /// \note O(log count) while shifts are pending, O(1) otherwise
+    int value(int index) const;
+
+    /// \brief old positions of handles changed by last movePosition, normalize or setPositions call,
+    /// starting from the first changed handle
+    const QVector<int>& previousPositions() const;
+
+    /// \brief old values of handles changed by last commitValues call,
+    /// starting from the first changed handle
+    const QVector<int>& previousValues() const;
+
+    /// \brief move handle and push its neighbours to keep minimum range
+    /// \param index    index of handle to move
+    /// \param arg  shift of handle position
+    /// \return range of handles which were actually moved
+    QPair<int, int> movePosition(int index, int arg);
+
+    /// \brief move handles to the nearest positions which keep minimum range and fit into range
+    /// \return range of handles which were moved
+    QPair<int, int> normalize();
+
+    /// \brief replace all positions and normalize them
+    /// \param positions    new positions, count must be equal to current count
+    /// \return range of handles which were moved
+    QPair<int, int> setPositions(const QVector<int>& positions);
+
+    /// \brief move positions and values of handles [first, last) by delta keeping distances between them
+    /// \note delta is cut so the block keeps minimum range from its neighbours and fits into range
+    /// \note costs O(log count), the shift stays pending until a call which needs all positions
+    /// \note previousPositions() is not changed, old positions are the new ones minus returned delta
+    /// \return applied delta
+    int shiftHandles(int first, int last, int delta);
+
+    /// \brief replace positions of handles starting from given index
+    /// \note positions are not normalized, they must keep constraints with their neighbours
+    /// \return range of handles which were moved
+    QPair<int, int> replacePositions(int first, const QVector<int>& positions);
+
+    /// \brief insert handles before given index with positions first, first + step, first + 2 * step...
+    /// \note positions are not normalized
+    void insertPositions(int index, int count, int first, int step);
+
+    /// \brief remove handles starting from given index
+    /// \note positions are not normalized
+    void removePositions(int index, int count);
+
+    /// \brief add handles to the left, moving existing ones to free the space
+    /// \return count of added handles
+    /// \note positions are not normalized
+    int addToLeft(int count);
+
+    /// \brief add handles to the right, moving existing ones to free the space
+    /// \return count of added handles
+    /// \note positions are not normalized
+    int addToRight(int count);
+
+    /// \brief insert handles evenly spaced between neighbours of given index
+    /// \return count of added handles
+    /// \note positions are not normalized
+    int insertHandles(int index, int count);
+
+    /// \brief start staging, positions moved until endStaging are reported by it at once
+    void beginStaging();
+
+    /// \brief check that positions are being staged
+    bool isStaging() const;
+
+    /// \brief set position without solving, it is normalized by endStaging
+    void stagePosition(int index, int position);
+
+    /// \brief normalize staged positions
+    /// \return range of handles moved since beginStaging, old positions are in previousPositions()
+    QPair<int, int> endStaging();
+
+    /// \brief copy positions which differ from values to values
+    /// \return range of changed values, old values are in previousValues()
+    QPair<int, int> commitValues();
+
+    /// \brief mark handles [first, last) as moved, so commitValues will check them
+    void markUncommitted(int first, int last);
+
+private:
+    /// \brief spacing for new handles added to the left or to the right
+    /// \param space    free space at the side handles are added to
+    int spacing(int space) const;
+
+    /// \brief sum of pending shifts of handle at given index
+    qint64 pendingShift(int index) const;
+
+    /// \brief add delta to pending shifts of handles from given index to the end
+    void addShift(int index, qint64 delta);
+
+    /// \brief add pending shifts to stored positions and values, O(count) if any is pending
+    void applyShifts() const;
+
+    int m_minimum;
+    int m_maximum;
+    int m_minimumRange;
+    int m_count;
+    int m_maxCount;
+
+    /// Positions on slider, without pending shifts.
+    /// Pending shifts are applied by const accessors too, so stored handles are mutable.
+    mutable Handles m_positions;
+
+    /// Values on slider, without pending shifts
+    mutable Handles m_values;
+
+    /// Fenwick tree of pending shifts, sized by count and kept zero while nothing is pending
+    mutable QVarLengthArray<qint64, InlineCount> m_shifts;
+    mutable bool m_shiftsPending;
+
+    /// see previousPositions(), it is passed to range signals as is, so it stays a QVector
+    QVector<int> m_previousPositions;
+
+    /// see previousValues()
+    QVector<int> m_previousValues;
+
+    /// positions at beginStaging, buffer is kept between transactions
+    Handles m_stagedFrom;
+    bool m_staging;
+
+    /// range [m_uncommittedFirst, m_uncommittedEnd) of positions which can differ from values
+    int m_uncommittedFirst;
+    int m_uncommittedEnd;
+};
+
+#endif //__MULTISLIDERMODEL_H__
@@ -0,0 +1,543 @@
+#include <QIODevice>
+
+#include <cstring>
+#include <limits>
+
+#include "MultiSlider.h"
+#include "MultiSliderRecording.h"
+
+namespace
+{
+
+const char Magic[4] = { 'M', 'S', 'R', 'C' };
+/// version 2 added ShiftTag, streams of version 1 are read too
+const char Version = 2;
+const char FirstVersion = 1;
+
+enum Tag
+{
+    /// first handle, count of handles and deltas of their values
+    ValuesTag = 1,
+    /// count of handles and all values, each as delta from the previous one
+    LayoutTag = 2,
+    MinimumRangeTag = 3,
+    /// minimum and maximum
+    RangeTag = 4,
+    /// first handle, count of handles and delta added to all of them
+    ShiftTag = 5
+};
+
+quint64 zigzag(qint64 value)
+{
+    return (quint64(value) << 1) ^ quint64(value >> 63);
+}
+
+qint64 unzigzag(quint64 value)
+{
+    return qint64(value >> 1) ^ -qint64(value & 1);
+}
+
+void appendVarint(QByteArray& buffer, quint64 value)
+{
+    while (value >= 0x80)
+    {
+        buffer.append(char(value | 0x80));
+        value >>= 7;
+    }
+    buffer.append(char(value));
+}
+
+void appendInt(QByteArray& buffer, qint64 value)
+{
+    appendVarint(buffer, zigzag(value));
+}
+
+} // namespace
+
+// -----------------------------------------------------------------------------
+
+MultiSliderRecorder::MultiSliderRecorder(MultiSlider* slider, QIODevice* device, QObject* parent)
+  : QObject(parent)
+  , m_slider(slider)
+  , m_device(device)
+  , m_lastTime(0)
+  , m_recording(false)
+  , m_recordedMinimum(0)
+  , m_recordedMaximum(0)
+  , m_recordedMinimumRange(0)
+{
+    Q_ASSERT(slider);
+    Q_ASSERT(device);
+    // reserved capacity is kept when buffer is cleared by resize(0)
+    m_buffer.reserve(64);
+}
+
+bool MultiSliderRecorder::isRecording() const
+{
+    return m_recording;
+}
+
+void MultiSliderRecorder::start()
+{
+    if (m_recording || !m_slider)
+    {
+        return;
+    }
+    m_recording = true;
+    if (!m_clock.isValid())
+    {
+        m_device->write(Magic, sizeof(Magic));
+        m_device->putChar(Version);
+        m_clock.start();
+    }
+    // changes made while recording was stopped are not in stream, so state is written again
+    writeRange();
+    writeMinimumRange();
+    writeLayout();
+
+    connect(m_slider, &MultiSlider::valuesRangeChanged, this, &MultiSliderRecorder::onValuesChanged);
+    connect(m_slider, &MultiSlider::valuesShifted, this, &MultiSliderRecorder::onValuesShifted);
+    connect(m_slider, &MultiSlider::countChanged, this, &MultiSliderRecorder::onCountChanged);
+    connect(m_slider, &MultiSlider::minimumRangeChanged, this, &MultiSliderRecorder::writePendingRange);
+    connect(m_slider, &QAbstractSlider::rangeChanged, this, &MultiSliderRecorder::writePendingRange);
+}
+
+void MultiSliderRecorder::stop()
+{
+    if (!m_recording)
+    {
+        return;
+    }
+    m_recording = false;
+    if (m_slider)
+    {
+        disconnect(m_slider, nullptr, this, nullptr);
+    }
+}
+
+void MultiSliderRecorder::onValuesChanged(int first, int last, const QVector<int>& oldValues, const QVector<int>& newValues)
+{
+    Q_UNUSED(oldValues);
+    writePendingRange();
+    if (last > m_values.size())
+    {
+        // count is not recorded yet, new values are written with it
+        writeLayout();
+        return;
+    }
+    beginRecord(ValuesTag);
+    appendVarint(m_buffer, first);
+    appendVarint(m_buffer, last - first);
+    for (int i = first; i < last; ++i)
+    {
+        const int value = newValues.at(i - first);
+        appendInt(m_buffer, qint64(value) - m_values.at(i));
+        m_values[i] = value;
+    }
+    endRecord();
+}
+
+void MultiSliderRecorder::onValuesShifted(int first, int last, int delta)
+{
+    writePendingRange();
+    beginRecord(ShiftTag);
+    appendVarint(m_buffer, first);
+    appendVarint(m_buffer, last - first);
+    appendInt(m_buffer, delta);
+    for (int i = first; i < last; ++i)
+    {
+        m_values[i] += delta;
+    }
+    endRecord();
+}
+
+void MultiSliderRecorder::onCountChanged()
+{
+    writePendingRange();
+    writeLayout();
+}
+
+void MultiSliderRecorder::writePendingRange()
+{
+    if (m_slider->minimum() != m_recordedMinimum || m_slider->maximum() != m_recordedMaximum)
+    {
+        writeRange();
+    }
+    if (m_slider->minimumRange() != m_recordedMinimumRange)
+    {
+        writeMinimumRange();
+    }
+}
+
+void MultiSliderRecorder::beginRecord(int tag)
+{
+    const qint64 time = m_clock.elapsed();
+    m_buffer.resize(0);
+    m_buffer.append(char(tag));
+    appendVarint(m_buffer, quint64(time - m_lastTime));
+    m_lastTime = time;
+}
+
+void MultiSliderRecorder::endRecord()
+{
+    m_device->write(m_buffer);
+}
+
+void MultiSliderRecorder::writeRange()
+{
+    m_recordedMinimum = m_slider->minimum();
+    m_recordedMaximum = m_slider->maximum();
+    beginRecord(RangeTag);
+    appendInt(m_buffer, m_recordedMinimum);
+    appendInt(m_buffer, m_recordedMaximum);
+    endRecord();
+}
+
+void MultiSliderRecorder::writeMinimumRange()
+{
+    m_recordedMinimumRange = m_slider->minimumRange();
+    beginRecord(MinimumRangeTag);
+    appendInt(m_buffer, m_recordedMinimumRange);
+    endRecord();
+}
+
+void MultiSliderRecorder::writeLayout()
+{
+    m_values = m_slider->values();
+    beginRecord(LayoutTag);
+    appendVarint(m_buffer, m_values.size());
+    qint64 previous = 0;
+    for (int value : qAsConst(m_values))
+    {
+        appendInt(m_buffer, value - previous);
+        previous = value;
+    }
+    endRecord();
+}
+
+// -----------------------------------------------------------------------------
+
+MultiSliderPlayer::MultiSliderPlayer(MultiSlider* slider, QIODevice* device, QObject* parent)
+  : QObject(parent)
+  , m_slider(slider)
+  , m_device(device)
+  , m_speed(1.0)
+  , m_playing(false)
+  , m_headerRead(false)
+  , m_recordPending(false)
+  , m_tag(0)
+  , m_recordTime(0)
+  , m_startTime(0)
+{
+    Q_ASSERT(slider);
+    Q_ASSERT(device);
+    m_timer.setSingleShot(true);
+    connect(&m_timer, &QTimer::timeout, this, &MultiSliderPlayer::onTimer);
+}
+
+double MultiSliderPlayer::speed() const
+{
+    return m_speed;
+}
+
+void MultiSliderPlayer::setSpeed(double arg)
+{
+    if (m_speed == arg)
+    {
+        return;
+    }
+    if (m_playing)
+    {
+        // continue from recorded time reached at old speed
+        m_startTime = m_speed > 0
+                ? qMin(m_recordTime, m_startTime + qint64(m_clock.elapsed() * m_speed))
+                : m_recordTime;
+        m_clock.restart();
+    }
+    m_speed = arg;
+    if (m_playing)
+    {
+        m_timer.start(int(qBound<qint64>(0, timeToRecord(), std::numeric_limits<int>::max())));
+    }
+}
+
+bool MultiSliderPlayer::isPlaying() const
+{
+    return m_playing;
+}
+
+bool MultiSliderPlayer::step()
+{
+    if (!m_headerRead && !readHeader())
+    {
+        return false;
+    }
+    if (!m_recordPending && !readRecordHeader())
+    {
+        return false;
+    }
+    return applyRecord();
+}
+
+void MultiSliderPlayer::start()
+{
+    if (m_playing)
+    {
+        return;
+    }
+    if ((!m_headerRead && !readHeader()) || (!m_recordPending && !readRecordHeader()))
+    {
+        finish();
+        return;
+    }
+    m_playing = true;
+    m_startTime = m_recordTime;
+    m_clock.start();
+    m_timer.start(0);
+}
+
+void MultiSliderPlayer::stop()
+{
+    m_playing = false;
+    m_timer.stop();
+}
+
+void MultiSliderPlayer::onTimer()
+{
+    for (int i = 0; i < MaxBatch && timeToRecord() <= 0; ++i)
+    {
+        if (!applyRecord() || !readRecordHeader())
+        {
+            finish();
+            return;
+        }
+        if (!m_playing)
+        {
+            // stopped by slot connected to slider
+            return;
+        }
+    }
+    m_timer.start(int(qBound<qint64>(0, timeToRecord(), std::numeric_limits<int>::max())));
+}
+
+void MultiSliderPlayer::finish()
+{
+    m_playing = false;
+    m_timer.stop();
+    emit finished();
+}
+
+bool MultiSliderPlayer::readHeader()
+{
+    char magic[sizeof(Magic)];
+    char version = 0;
+    if (m_device->read(magic, sizeof(magic)) != sizeof(magic)
+            || std::memcmp(magic, Magic, sizeof(Magic)) != 0
+            || !m_device->getChar(&version)
+            || version < FirstVersion || version > Version)
+    {
+        return false;
+    }
+    m_headerRead = true;
+    return true;
+}
+
+bool MultiSliderPlayer::readRecordHeader()
+{
+    char tag = 0;
+    quint64 delay = 0;
+    if (!m_device->getChar(&tag) || !readVarint(delay))
+    {
+        return false;
+    }
+    m_tag = uchar(tag);
+    m_recordTime += qint64(delay);
+    m_recordPending = true;
+    return true;
+}
+
+bool MultiSliderPlayer::applyRecord()
+{
+    m_recordPending = false;
+    switch (m_tag)
+    {
+    case ValuesTag:
+    {
+        int first = 0;
+        int count = 0;
+        if (!readCount(first) || !readCount(count) || count > m_values.size() - first)
+        {
+            return false;
+        }
+        for (int i = first; i < first + count; ++i)
+        {
+            quint64 delta = 0;
+            if (!readVarint(delta))
+            {
+                return false;
+            }
+            m_values[i] = int(m_values.at(i) + unzigzag(delta));
+        }
+        if (!m_slider || first + count > m_slider->count())
+        {
+            return true;
+        }
+        if (count == m_slider->count())
+        {
+            m_slider->setValues(m_values);
+        }
+        else
+        {
+            MultiSliderTransaction transaction(m_slider);
+            for (int i = first; i < first + count; ++i)
+            {
+                m_slider->setValue(i, m_values.at(i));
+            }
+        }
+        return true;
+    }
+    case ShiftTag:
+    {
+        int first = 0;
+        int count = 0;
+        int delta = 0;
+        if (!readCount(first) || !readCount(count) || count > m_values.size() - first || !readInt(delta))
+        {
+            return false;
+        }
+        for (int i = first; i < first + count; ++i)
+        {
+            m_values[i] += delta;
+        }
+        if (m_slider && first + count <= m_slider->count())
+        {
+            m_slider->shiftValues(first, first + count, delta);
+        }
+        return true;
+    }
+    case LayoutTag:
+    {
+        int count = 0;
+        // recorded count fits into the same range and minimum range, which are replayed before it
+        if (!readCount(count) || (m_slider && count > m_slider->maxCount()))
+        {
+            return false;
+        }
+        // values are appended as they are read, so a corrupt count can not allocate
+        // more memory than the stream really holds
+        m_values.resize(0);
+        qint64 previous = 0;
+        for (int i = 0; i < count; ++i)
+        {
+            quint64 delta = 0;
+            if (!readVarint(delta))
+            {
+                return false;
+            }
+            previous += unzigzag(delta);
+            m_values.append(int(previous));
+        }
+        if (!m_slider)
+        {
+            return true;
+        }
+        if (m_slider->count() < count)
+        {
+            m_slider->addToRight(count - m_slider->count());
+        }
+        else if (m_slider->count() > count)
+        {
+            m_slider->removeFromRight(m_slider->count() - count);
+        }
+        if (m_slider->count() == count)
+        {
+            m_slider->setValues(m_values);
+        }
+        return true;
+    }
+    case MinimumRangeTag:
+    {
+        int minimumRange = 0;
+        if (!readInt(minimumRange))
+        {
+            return false;
+        }
+        if (m_slider)
+        {
+            m_slider->setMinimumRange(minimumRange);
+        }
+        return true;
+    }
+    case RangeTag:
+    {
+        int min = 0;
+        int max = 0;
+        if (!readInt(min) || !readInt(max))
+        {
+            return false;
+        }
+        if (m_slider)
+        {
+            m_slider->setRange(min, max);
+        }
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+bool MultiSliderPlayer::readVarint(quint64& value)
+{
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7)
+    {
+        char byte = 0;
+        if (!m_device->getChar(&byte))
+        {
+            return false;
+        }
+        value |= quint64(uchar(byte) & 0x7f) << shift;
+        if (!(uchar(byte) & 0x80))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool MultiSliderPlayer::readInt(int& value)
+{
+    quint64 encoded = 0;
+    if (!readVarint(encoded))
+    {
+        return false;
+    }
+    const qint64 decoded = unzigzag(encoded);
+    if (decoded < std::numeric_limits<int>::min() || decoded > std::numeric_limits<int>::max())
+    {
+        return false;
+    }
+    value = int(decoded);
+    return true;
+}
+
+bool MultiSliderPlayer::readCount(int& value)
+{
+    quint64 encoded = 0;
+    if (!readVarint(encoded) || encoded > quint64(std::numeric_limits<int>::max()))
+    {
+        return false;
+    }
+    value = int(encoded);
+    return true;
+}
+
+qint64 MultiSliderPlayer::timeToRecord() const
+{
+    if (m_speed <= 0)
+    {
+        return 0;
+    }
+    return qint64((m_recordTime - m_startTime) / m_speed) - m_clock.elapsed();
+}
@@ -0,0 +1,158 @@
+#ifndef __MULTISLIDERRECORDING_H__
+#define __MULTISLIDERRECORDING_H__
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QObject>
+#include <QPointer>
+#include <QTimer>
+#include <QVector>
+
+class QIODevice;
+class MultiSlider;
+
+/// Writes committed changes of a MultiSlider to an append-only binary stream.
+/// Stream starts with a header and the current state of the slider, then each change is a record:
+/// tag byte, milliseconds since the previous record and payload.
+/// Integers are varints, signed ones are zigzag encoded, values are stored as deltas
+/// from the previously recorded values of the same handles, so small moves take a few bytes.
+/// Shift of a block of handles is one record whatever size of the block.
+/// Range and minimum range are written before values and layouts they were changed together with,
+/// so each record is replayed against the limits it was recorded with.
+/// \see MultiSliderPlayer
+class MultiSliderRecorder : public QObject
+{
+    Q_OBJECT
+
+public:
+    /// \param slider   slider to record
+    /// \param device   open writable device, it is not owned by recorder
+    MultiSliderRecorder(MultiSlider* slider, QIODevice* device, QObject* parent = nullptr);
+
+    /// \brief check that changes are being written
+    bool isRecording() const;
+
+public slots:
+    /// \brief write header and the current state of the slider, then write each change
+    void start();
+
+    /// \brief stop writing changes, device is left open
+    void stop();
+
+private:
+    void onValuesChanged(int first, int last, const QVector<int>& oldValues, const QVector<int>& newValues);
+    void onValuesShifted(int first, int last, int delta);
+    void onCountChanged();
+
+    /// \brief write range and minimum range if they differ from the recorded ones.
+    /// Slider handles range changes before recorder does, and values it changes there
+    /// are reported first, so each record starts with pending range.
+    void writePendingRange();
+
+    /// \brief start record in buffer
+    void beginRecord(int tag);
+    /// \brief write buffered record to device
+    void endRecord();
+    void writeRange();
+    void writeMinimumRange();
+    void writeLayout();
+
+    QPointer<MultiSlider> m_slider;
+    QIODevice* m_device;
+    QElapsedTimer m_clock;
+    /// time of the last record, clock is started when header is written
+    qint64 m_lastTime;
+    bool m_recording;
+
+    /// values as they are recorded in stream, deltas are taken from them
+    QVector<int> m_values;
+
+    /// range and minimum range as they are recorded in stream
+    int m_recordedMinimum;
+    int m_recordedMaximum;
+    int m_recordedMinimumRange;
+
+    /// record being written, reused to not allocate on each change
+    QByteArray m_buffer;
+};
+
+/// Replays stream written by MultiSliderRecorder into a MultiSlider.
+/// Records are read from device one by one when they are due, so stream of any length
+/// is never loaded into memory.
+/// \note speed 1 replays changes with original delays, speed 0 replays them without delays
+class MultiSliderPlayer : public QObject
+{
+    Q_OBJECT
+
+public:
+    /// \param slider   slider to replay changes into
+    /// \param device   open readable device positioned at the beginning of stream, it is not owned by player
+    MultiSliderPlayer(MultiSlider* slider, QIODevice* device, QObject* parent = nullptr);
+
+    /// \brief this property holds replay speed relative to recorded one
+    double speed() const;
+
+    /// \brief set replay speed, 1 (the default) is original speed, 0 applies records without delays
+    void setSpeed(double arg);
+
+    /// \brief check that records are being replayed by timer
+    bool isPlaying() const;
+
+    /// \brief apply the next record immediately, ignoring its timestamp
+    /// \return false at end of stream or if stream is malformed
+    bool step();
+
+public slots:
+    /// \brief replay records with their recorded delays divided by speed
+    void start();
+
+    /// \brief pause replay, start continues from the next record
+    void stop();
+
+signals:
+    /// \brief this signal is emitted when replay reaches end of stream
+    void finished();
+
+private:
+    enum
+    {
+        /// records applied per timer event when they are due at once,
+        /// so the event loop keeps running at high speed
+        MaxBatch = 256
+    };
+
+    void onTimer();
+    void finish();
+
+    bool readHeader();
+    /// \brief read tag and timestamp of the next record
+    bool readRecordHeader();
+    /// \brief read payload of pending record and apply it to slider
+    bool applyRecord();
+
+    bool readVarint(quint64& value);
+    bool readInt(int& value);
+    bool readCount(int& value);
+
+    /// \brief milliseconds of wall clock left until pending record is due
+    qint64 timeToRecord() const;
+
+    QPointer<MultiSlider> m_slider;
+    QIODevice* m_device;
+    QTimer m_timer;
+    QElapsedTimer m_clock;
+    double m_speed;
+    bool m_playing;
+    bool m_headerRead;
+    bool m_recordPending;
+    int m_tag;
+
+    /// recorded time of pending record and of the record replay was started from
+    qint64 m_recordTime;
+    qint64 m_startTime;
+
+    /// values as they are recorded in stream, deltas are applied to them
+    QVector<int> m_values;
+};
+
+#endif //__MULTISLIDERRECORDING_H__
@@ -0,0 +1,63 @@
+#include <QtGlobal>
+
+#include <algorithm>
+#include <cmath>
+
+#include "MultiSliderSnapIndex.h"
+
+MultiSliderSnapIndex::MultiSliderSnapIndex()
+{
+}
+
+const QVector<int>& MultiSliderSnapIndex::markers() const
+{
+    return m_markers;
+}
+
+void MultiSliderSnapIndex::setMarkers(const QVector<int>& markers)
+{
+    m_markers = markers;
+    std::sort(m_markers.begin(), m_markers.end());
+    m_markers.erase(std::unique(m_markers.begin(), m_markers.end()), m_markers.end());
+}
+
+bool MultiSliderSnapIndex::nearestMarker(int position, int low, int high, int& target) const
+{
+    if (low > high)
+    {
+        return false;
+    }
+    // nearest marker in [low, high] is around the clamped position
+    const int clamped = qBound(low, position, high);
+    const auto it = std::lower_bound(m_markers.constBegin(), m_markers.constEnd(), clamped);
+    const bool hasAbove = it != m_markers.constEnd() && *it <= high;
+    const bool hasBelow = it != m_markers.constBegin() && *(it - 1) >= low;
+    if (hasAbove && (!hasBelow || qint64(*it) - position < qint64(position) - *(it - 1)))
+    {
+        target = *it;
+        return true;
+    }
+    if (hasBelow)
+    {
+        target = *(it - 1);
+        return true;
+    }
+    return false;
+}
+
+bool MultiSliderSnapIndex::nearestStep(int origin, int step, int position, int low, int high, int& target)
+{
+    if (step <= 0 || low > high)
+    {
+        return false;
+    }
+    const qint64 first = qint64(std::ceil(double(qint64(low) - origin) / step));
+    const qint64 last = qint64(std::floor(double(qint64(high) - origin) / step));
+    if (first > last)
+    {
+        return false;
+    }
+    const qint64 nearest = qRound64(double(qint64(position) - origin) / step);
+    target = int(origin + qBound(first, nearest, last) * step);
+    return true;
+}
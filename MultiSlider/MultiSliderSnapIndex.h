@@ -0,0 +1,34 @@
+#ifndef __MULTISLIDERSNAPINDEX_H__
+#define __MULTISLIDERSNAPINDEX_H__
+
+#include <QVector>
+
+/// Snap targets of MultiSlider handles.
+/// Markers are kept sorted, so the nearest one is found by binary search in O(log m).
+/// Ticks and grid are regular steps, their nearest target is computed directly.
+class MultiSliderSnapIndex
+{
+public:
+    MultiSliderSnapIndex();
+
+    /// \brief sorted markers without duplicates
+    const QVector<int>& markers() const;
+
+    /// \brief set markers, they are sorted and duplicates are removed
+    void setMarkers(const QVector<int>& markers);
+
+    /// \brief find marker nearest to position in [low, high]
+    /// \param target   nearest marker, it is not changed if there is no marker in [low, high]
+    /// \return false if there is no marker in [low, high]
+    bool nearestMarker(int position, int low, int high, int& target) const;
+
+    /// \brief find value origin + k * step nearest to position in [low, high]
+    /// \param target   nearest value, it is not changed if there is no such value in [low, high]
+    /// \return false if there is no such value in [low, high] or step is not positive
+    static bool nearestStep(int origin, int step, int position, int low, int high, int& target);
+
+private:
+    QVector<int> m_markers;
+};
+
+#endif //__MULTISLIDERSNAPINDEX_H__
@@ -0,0 +1,38 @@
+#include <QtGlobal>
+
+#include <algorithm>
+
+#include "MultiSliderSnapshot.h"
+
+MultiSliderSnapshot::MultiSliderSnapshot()
+    : m_middle(1)
+    , m_back(2)
+    , m_front(0)
+{
+}
+
+void MultiSliderSnapshot::publish(const int* values, int count)
+{
+    std::vector<int>& buffer = m_buffers[m_back];
+    buffer.assign(values, values + count);
+    // release makes the filled buffer visible to reader together with the index
+    m_back = m_middle.fetchAndStoreAcqRel(m_back | Dirty) & IndexMask;
+}
+
+bool MultiSliderSnapshot::hasUpdate() const
+{
+    return m_middle.loadAcquire() & Dirty;
+}
+
+int MultiSliderSnapshot::read(int* values, int capacity)
+{
+    if (hasUpdate())
+    {
+        // acquire makes the buffer filled by writer visible
+        m_front = m_middle.fetchAndStoreAcqRel(m_front) & IndexMask;
+    }
+    const std::vector<int>& buffer = m_buffers[m_front];
+    const int count = int(buffer.size());
+    std::copy(buffer.begin(), buffer.begin() + qMin(count, capacity), values);
+    return count;
+}
@@ -0,0 +1,57 @@
+#ifndef __MULTISLIDERSNAPSHOT_H__
+#define __MULTISLIDERSNAPSHOT_H__
+
+#include <QAtomicInt>
+
+#include <vector>
+
+/// Latest committed values of MultiSlider handles for a reader on another thread.
+/// Triple buffer: the writer fills its own buffer and swaps it with the middle one,
+/// the reader swaps the middle buffer with its own one when there is a new snapshot.
+/// Reading never blocks, never allocates and always sees values of one commit.
+/// \note one writer thread (the GUI thread) and one reader thread
+class MultiSliderSnapshot
+{
+public:
+    MultiSliderSnapshot();
+
+    /// \brief publish new values, called by writer thread
+    /// \param values  values of all handles
+    /// \param count   count of handles
+    /// \note allocates only when count of values grows
+    void publish(const int* values, int count);
+
+    /// \brief check that snapshot newer than the last read one was published
+    /// \note wait-free, can be called by reader thread only
+    bool hasUpdate() const;
+
+    /// \brief copy latest published values, called by reader thread
+    /// \param values   buffer for values
+    /// \param capacity size of buffer, values above it are not copied
+    /// \return count of published values, it can be more than capacity
+    /// \note wait-free and does not allocate
+    int read(int* values, int capacity);
+
+private:
+    enum
+    {
+        IndexMask = 3,
+        /// middle buffer holds values not seen by reader
+        Dirty = 4
+    };
+
+    std::vector<int> m_buffers[3];
+
+    /// index of the middle buffer and Dirty flag
+    QAtomicInt m_middle;
+
+    /// buffer owned by writer
+    int m_back;
+
+    /// buffer owned by reader
+    int m_front;
+
+    Q_DISABLE_COPY(MultiSliderSnapshot)
+};
+
+#endif //__MULTISLIDERSNAPSHOT_H__
@@ -0,0 +1,131 @@
+#ifndef __MULTISLIDERSOLVER_H__
+#define __MULTISLIDERSOLVER_H__
+
+#include <QtGlobal>
+
+/// Constraint solver of MultiSliderModel.
+/// Works on plain arrays of sorted positions and is inlined into the model.
+/// Positions are written only through given replace(index, position) function.
+namespace MultiSliderSolver
+{
+/// range of positions and minimum range between handles
+struct Constraints
+{
+    int minimum;
+    int maximum;
+    int minimumRange;
+};
+
+/// last handle pushed by a moved one and its new position, see walkCascade
+struct Cascade
+{
+    int last;
+    int lastPosition;
+};
+
+/// \brief find handles pushed by handle at given index moved by arg.
+/// Walk in move direction while the handle pushes its neighbour.
+/// Each pushed neighbour is moved by the rest of the shift; the last
+/// walked handle is the one which has enough space or the last one on slider.
+/// Direction can change only on the last handle, when the rest is zero.
+inline Cascade walkCascade(const int* positions, int count, int index, int arg, const Constraints& c)
+{
+    int last = index;
+    int lastArg = arg;
+    forever
+    {
+        const int position = positions[last];
+        if(last == (lastArg < 0 ? 0 : (count - 1)))
+        {
+            return Cascade{ last, qBound(c.minimum + c.minimumRange, position + lastArg, c.maximum - c.minimumRange) };
+        }
+        const int nextStep = lastArg < 0 ? -1 : 1;
+        const int nextRange = c.minimumRange * nextStep;
+        const int nextPosition = positions[last + nextStep];
+        if(qAbs(lastArg) < qAbs(position - nextPosition + nextRange))
+        {
+            return Cascade{ last, position + lastArg };
+        }
+        lastArg = lastArg - (nextPosition - position) + nextRange;
+        last += nextStep;
+    }
+}
+
+/// \brief walk back from the last pushed handle to the moved one
+/// and put each handle at minimum range from the next one
+template<class Replace>
+inline void placeCascade(const int* positions, int index, const Cascade& cascade, int minimumRange, Replace replace)
+{
+    replace(cascade.last, cascade.lastPosition);
+    const int step = cascade.last < index ? -1 : 1;
+    const int range = minimumRange * step;
+    for(int i = cascade.last; i != index; )
+    {
+        i -= step;
+        replace(i, positions[i + step] - range);
+    }
+}
+
+/// \brief projection to the nearest valid positions: each handle is pushed right to keep
+/// minimum range from its left neighbour (or from minimum), then pulled left to keep
+/// minimum range from its right neighbour (or from maximum).
+/// Gives the same result as resolving each violation with a cascade,
+/// while count of handles fits into the range.
+/// \note replace is called only for positions which violate constraints
+template<class Replace>
+inline void normalize(const int* positions, int count, const Constraints& c, Replace replace)
+{
+    int bound = c.minimum;
+    for(int i = 0; i < count; ++i)
+    {
+        bound += c.minimumRange;
+        if(positions[i] < bound)
+        {
+            replace(i, bound);
+        }
+        bound = positions[i];
+    }
+    bound = c.maximum;
+    for(int i = count - 1; i >= 0; --i)
+    {
+        bound -= c.minimumRange;
+        if(positions[i] > bound)
+        {
+            replace(i, bound);
+        }
+        bound = positions[i];
+    }
+}
+
+/// \brief normalize small counts of handles with count known at compile time.
+/// FixedCount<MaxCount>::normalize calls normalize with constant count for counts up to MaxCount,
+/// so its loops are unrolled by compiler. Larger counts are normalized by the loops as they are.
+template<int Count>
+struct FixedCount
+{
+    template<class Replace>
+    static void normalize(const int* positions, int count, const Constraints& c, Replace replace)
+    {
+        if(count == Count)
+        {
+            MultiSliderSolver::normalize(positions, Count, c, replace);
+        }
+        else
+        {
+            FixedCount<Count - 1>::normalize(positions, count, c, replace);
+        }
+    }
+};
+
+template<>
+struct FixedCount<0>
+{
+    template<class Replace>
+    static void normalize(const int* positions, int count, const Constraints& c, Replace replace)
+    {
+        MultiSliderSolver::normalize(positions, count, c, replace);
+    }
+};
+}
+
+#endif //__MULTISLIDERSOLVER_H__
@@ -0,0 +1,40 @@
+#ifndef __MULTISLIDERSTATS_H__
+#define __MULTISLIDERSTATS_H__
+
+#include <QtGlobal>
+
+/// Counters of MultiSlider hot paths, see MultiSlider::setStatsEnabled.
+/// Counters are accumulated since stats were enabled or reset, durations are in nanoseconds.
+struct MultiSliderStats
+{
+    /// calls of movePosition
+    quint64 solverCalls = 0;
+    /// handles moved by all movePosition calls
+    quint64 cascadeHandles = 0;
+    /// maximum count of handles moved by one movePosition call
+    int maxCascadeDepth = 0;
+
+    /// calls of normalize
+    quint64 normalizeCalls = 0;
+    /// handles moved by all normalize calls
+    quint64 normalizeHandles = 0;
+
+    /// emitted positionsRangeChanged, positionsShifted and positionsChanged signals
+    quint64 positionsSignals = 0;
+    /// emitted valuesRangeChanged, valuesShifted and valuesChanged signals
+    quint64 valuesSignals = 0;
+
+    /// handled paint events
+    quint64 paintEvents = 0;
+    /// time spent in paint events
+    qint64 paintNsecs = 0;
+    /// handles and segments drawn by paint events
+    quint64 itemsDrawn = 0;
+
+    /// calls of handleAtPos and posBetweenHandles
+    quint64 hitTests = 0;
+    /// time spent in hit tests
+    qint64 hitTestNsecs = 0;
+};
+
+#endif //__MULTISLIDERSTATS_H__
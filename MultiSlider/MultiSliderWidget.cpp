@@ -3,15 +3,29 @@
 
 #include <QVBoxLayout>
 #include <QKeyEvent>
+#include <QPainter>
 #include <QStyleOptionSpinBox>
 #include <QSpinBox>
 #include <QPushButton>
+#include <QTimer>
+
+#include <limits>
+
+namespace
+{
+/// held key doubles its step after this count of auto repeats
+const int RepeatsToDoubleStep = 8;
+/// accelerated step is not more than this part of the slider range
+const int MinStepsPerRange = 50;
+}
 
 class MultiSliderWidget::SpinBox : public QSpinBox
 {
 public:
     SpinBox(int index, QWidget* parent = 0);
     int index() const;
+    void setIndex(int index);
+    void setFocusColor(const QColor& color);
 
 protected:
     void focusInEvent(QFocusEvent* event) override;
@@ -19,6 +33,7 @@ protected:
 
 private:
     int m_index;
+    QString m_focusStyleSheet;
 };
 
 MultiSliderWidget::SpinBox::SpinBox(int index_, QWidget* parent)
@@ -32,10 +47,24 @@ int MultiSliderWidget::SpinBox::index() const
     return m_index;
 }
 
+void MultiSliderWidget::SpinBox::setIndex(int index_)
+{
+    m_index = index_;
+}
+
+void MultiSliderWidget::SpinBox::setFocusColor(const QColor& color)
+{
+    m_focusStyleSheet = "background-color: " + color.name() + ";";
+    if (hasFocus())
+    {
+        setStyleSheet(m_focusStyleSheet);
+    }
+}
+
 void MultiSliderWidget::SpinBox::focusInEvent(QFocusEvent* event)
 {
     selectAll();
-    setStyleSheet("background-color: " + MultiSlider::color(m_index, 0.93).name() + ";");
+    setStyleSheet(m_focusStyleSheet);
     QSpinBox::focusInEvent(event);
 }
 
@@ -45,6 +74,136 @@ void MultiSliderWidget::SpinBox::focusOutEvent(QFocusEvent* event)
     QSpinBox::focusOutEvent(event);
 }
 
+/// Labels painted in equal cells instead of a spin box for each label.
+/// Only label values are stored, text of visible labels is laid out when painted.
+class MultiSliderWidget::LabelStrip : public QWidget
+{
+public:
+    LabelStrip(MultiSliderWidget* widget);
+    void setCount(int count);
+    int count() const;
+    void setValue(int index, int value);
+    void setCurrent(int index);
+    QRect labelRect(int index) const;
+    int labelAt(const QPoint& pos) const;
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+    void mousePressEvent(QMouseEvent* event) override;
+
+private:
+    MultiSliderWidget* m_widget;
+    QVector<int> m_values;
+    int m_current = -1;
+};
+
+MultiSliderWidget::LabelStrip::LabelStrip(MultiSliderWidget* widget)
+    : QWidget(widget)
+    , m_widget(widget)
+{
+    setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
+}
+
+void MultiSliderWidget::LabelStrip::setCount(int count)
+{
+    if (m_values.size() == count)
+    {
+        return;
+    }
+    m_values.resize(count);
+    if (m_current >= count)
+    {
+        m_current = -1;
+    }
+    update();
+}
+
+int MultiSliderWidget::LabelStrip::count() const
+{
+    return m_values.size();
+}
+
+void MultiSliderWidget::LabelStrip::setValue(int index, int value)
+{
+    if (m_values.at(index) != value)
+    {
+        m_values[index] = value;
+        update(labelRect(index));
+    }
+}
+
+void MultiSliderWidget::LabelStrip::setCurrent(int index)
+{
+    if (m_current == index)
+    {
+        return;
+    }
+    if (m_current != -1)
+    {
+        update(labelRect(m_current));
+    }
+    m_current = index;
+    if (m_current != -1)
+    {
+        update(labelRect(m_current));
+    }
+}
+
+QRect MultiSliderWidget::LabelStrip::labelRect(int index) const
+{
+    const int left = int(qint64(width()) * index / count());
+    const int right = int(qint64(width()) * (index + 1) / count());
+    return QRect(left, 0, right - left, height());
+}
+
+int MultiSliderWidget::LabelStrip::labelAt(const QPoint& pos) const
+{
+    if (count() == 0 || pos.x() < 0 || pos.x() >= width())
+    {
+        return -1;
+    }
+    return int(qint64(pos.x()) * count() / width());
+}
+
+void MultiSliderWidget::LabelStrip::paintEvent(QPaintEvent* event)
+{
+    if (count() == 0)
+    {
+        return;
+    }
+    QPainter painter(this);
+    const QFontMetrics metrics = fontMetrics();
+    const int first = qMax(0, labelAt(event->rect().topLeft()));
+    const int last = labelAt(QPoint(qMin(event->rect().right(), width() - 1), 0));
+    for (int i = first; i <= last; ++i)
+    {
+        const QRect rect = labelRect(i);
+        if (i == m_current)
+        {
+            painter.fillRect(rect, m_widget->multiSlider->segmentBackgroundColor(i));
+        }
+        const QString text = QString::number(m_values.at(i));
+        if (metrics.horizontalAdvance(text) > rect.width())
+        {
+            // label does not fit into its cell
+            continue;
+        }
+        painter.drawText(rect, Qt::AlignCenter, text);
+    }
+}
+
+void MultiSliderWidget::LabelStrip::mousePressEvent(QMouseEvent* event)
+{
+    const int index = labelAt(event->pos());
+    if (index == -1)
+    {
+        QWidget::mousePressEvent(event);
+        return;
+    }
+    m_widget->editLabel(index);
+    event->accept();
+}
+
 MultiSliderWidget::MultiSliderWidget(QWidget* parent)
     : QFrame(parent)
 {
@@ -58,9 +217,14 @@ MultiSliderWidget::MultiSliderWidget(QWidget* parent)
     setLabelsUnder(true);
     onSliderCountChanged(multiSlider->count());
     onSelectedHandleChanged(multiSlider->selectedHandle());
-    onSliderPositionsChanged(multiSlider->positions());
+    onSliderPositionsChanged(0, multiSlider->count());
     installEventFilter(this);
 
+    keyTimer = new QTimer(this);
+    keyTimer->setSingleShot(true);
+    keyTimer->setTimerType(Qt::PreciseTimer);
+    connect(keyTimer, &QTimer::timeout, this, &MultiSliderWidget::flushKeySteps);
+
     onLabelsUnderChanged();
 }
 
@@ -92,6 +256,16 @@ QPushButton* MultiSliderWidget::GetButtonRemoveFromRight()
 bool MultiSliderWidget::eventFilter(QObject *obj, QEvent *event)
 {
     Q_UNUSED(obj);
+    if (event->type() == QEvent::KeyRelease)
+    {
+        // steps of held key are applied when it is released
+        if (!static_cast<QKeyEvent*>(event)->isAutoRepeat())
+        {
+            flushKeySteps();
+            keyRepeats = 0;
+        }
+        return false;
+    }
     if (event->type() == QEvent::KeyPress)
     {
         QKeyEvent* keyEvent = static_cast<QKeyEvent*>(event);
@@ -117,15 +291,16 @@ bool MultiSliderWidget::eventFilter(QObject *obj, QEvent *event)
                 selectNextSpinBox();
                 break;
             case Qt::Key_Left:
-                if (handle >= 0)
-                {
-                    multiSlider->setPosition(handle, multiSlider->position(handle) - 1);
-                }
-                break;
             case Qt::Key_Right:
+            case Qt::Key_PageDown:
+            case Qt::Key_PageUp:
                 if (handle >= 0)
                 {
-                    multiSlider->setPosition(handle, multiSlider->position(handle) + 1);
+                    const bool page = keyEvent->key() == Qt::Key_PageUp || keyEvent->key() == Qt::Key_PageDown
+                            || (keyEvent->modifiers() & Qt::ShiftModifier);
+                    const int step = page ? multiSlider->pageStep() : multiSlider->singleStep();
+                    const bool forward = keyEvent->key() == Qt::Key_Right || keyEvent->key() == Qt::Key_PageUp;
+                    stepHandle(handle, forward ? step : -step, keyEvent->isAutoRepeat());
                 }
                 break;
         }
@@ -134,6 +309,46 @@ bool MultiSliderWidget::eventFilter(QObject *obj, QEvent *event)
     return false;
 }
 
+void MultiSliderWidget::stepHandle(int handle, int delta, bool autoRepeat)
+{
+    if (handle != keyHandle)
+    {
+        flushKeySteps();
+        keyHandle = handle;
+    }
+    if (!autoRepeat)
+    {
+        // single press moves at once
+        keyRepeats = 0;
+        keyDelta += delta;
+        flushKeySteps();
+        return;
+    }
+    ++keyRepeats;
+    const qint64 limit = qMax<qint64>(qAbs(delta), (qint64(multiSlider->maximum()) - multiSlider->minimum()) / MinStepsPerRange);
+    const qint64 accelerated = delta * (qint64(1) << qMin(keyRepeats / RepeatsToDoubleStep, 30));
+    keyDelta += qBound(-limit, accelerated, limit);
+    // repeats faster than screen frames are summed and moved once per frame
+    if (!keyTimer->isActive())
+    {
+        keyTimer->start(multiSlider->frameInterval());
+    }
+}
+
+void MultiSliderWidget::flushKeySteps()
+{
+    keyTimer->stop();
+    const qint64 delta = keyDelta;
+    keyDelta = 0;
+    if (delta && keyHandle >= 0 && keyHandle < multiSlider->count())
+    {
+        // step is not snapped back to the target it starts from
+        const qint64 span = qMin<qint64>(qint64(multiSlider->maximum()) - multiSlider->minimum(),
+                                         std::numeric_limits<int>::max());
+        multiSlider->stepPosition(keyHandle, int(qBound(-span, delta, span)));
+    }
+}
+
 void MultiSliderWidget::createWidget()
 {
     widgetLayout = new QHBoxLayout();
@@ -188,6 +403,7 @@ MultiSliderWidget::SpinBox* MultiSliderWidget::createSpinBox(int index)
     spinBox->setKeyboardTracking(false);
     spinBox->setSizePolicy(QSizePolicy::Minimum, QSizePolicy::Fixed);
     spinBox->setAlignment(Qt::AlignCenter);
+    spinBox->setFocusColor(multiSlider->segmentBackgroundColor(index));
     return spinBox;
 }
 
@@ -199,11 +415,13 @@ void MultiSliderWidget::initMultiSlider()
     multiSlider->setCount(3);
     multiSlider->installEventFilter(this);
     connect(multiSlider, &MultiSlider::selectedHandleChanged, this, &MultiSliderWidget::onSelectedHandleChanged);
-    connect(multiSlider, &MultiSlider::positionsChanged, this, &MultiSliderWidget::onSliderPositionsChanged);
+    connect(multiSlider, &MultiSlider::positionsRangeChanged, this, &MultiSliderWidget::onSliderPositionsMoved);
+    connect(multiSlider, &MultiSlider::positionsShifted, this, &MultiSliderWidget::onSliderPositionsShifted);
     connect(multiSlider, &MultiSlider::countChanged, this, &MultiSliderWidget::updateButtonsEnable);
     connect(multiSlider, &MultiSlider::maxCountChanged, this, &MultiSliderWidget::updateButtonsEnable);
     connect(multiSlider, &MultiSlider::countChanged, this, &MultiSliderWidget::onSliderCountChanged);
     connect(multiSlider, &MultiSlider::rangeChanged, this, &MultiSliderWidget::onSliderRangeChanged);
+    connect(multiSlider, &MultiSlider::colorSchemeChanged, this, &MultiSliderWidget::onSliderColorSchemeChanged);
 }
 
 void MultiSliderWidget::updateButtonsEnable()
@@ -216,12 +434,41 @@ void MultiSliderWidget::updateButtonsEnable()
     removeFromLeftButton->setEnabled(count > 1);
 }
 
-void MultiSliderWidget::onSliderCountChanged(int count)
+int MultiSliderWidget::labelsCount() const
 {
-    int spinBoxesCount = count;
+    int count = multiSlider->count();
     if(showDifferences() && count > 0)
     {
-        spinBoxesCount++; //add extra spinbox for distance between maximum and last value
+        count++; //add extra label for distance between maximum and last value
+    }
+    return count;
+}
+
+int MultiSliderWidget::labelValue(int i) const
+{
+    const int count = multiSlider->count();
+    if(i == count)
+    {
+        return multiSlider->maximum() - multiSlider->position(count - 1);
+    }
+    if(showDifferences())
+    {
+        return multiSlider->position(i) - (i ? multiSlider->position(i - 1) : multiSlider->minimum());
+    }
+    return multiSlider->position(i);
+}
+
+void MultiSliderWidget::onSliderCountChanged(int count)
+{
+    Q_UNUSED(count);
+    int spinBoxesCount = labelStrip ? 0 : labelsCount();
+    if(labelStrip)
+    {
+        labelStrip->setCount(labelsCount());
+        if(labelEditor->index() >= labelsCount())
+        {
+            labelEditor->hide();
+        }
     }
     while (spinBoxes.size() > spinBoxesCount) //remove extra spinbox
     {
@@ -236,7 +483,7 @@ void MultiSliderWidget::onSliderCountChanged(int count)
         spinBoxes.append(spinBox);
         labelsLayout->insertWidget(labelsLayout->count(), spinBox);
     }
-    onSliderPositionsChanged(multiSlider->positions());
+    onSliderPositionsChanged(0, multiSlider->count());
 }
 
 void MultiSliderWidget::onSelectedHandleChanged(int handle)
@@ -245,36 +492,80 @@ void MultiSliderWidget::onSelectedHandleChanged(int handle)
     {
         return;
     }
+    if(labelStrip)
+    {
+        labelStrip->setCurrent(handle);
+        return;
+    }
     spinBoxes.at(handle)->setFocus();
 }
 
-void MultiSliderWidget::onSliderPositionsChanged(QVector<int> values)
+void MultiSliderWidget::onSliderPositionsChanged(int first, int last)
 {
     if(multiSlider->count() == 0)
     {
         return;
     }
-    for (auto spinBox : spinBoxes)
+    if(showDifferences())
     {
-        spinBox->blockSignals(true);
+        // distance after last moved handle changed too
+        last = qMin(last + 1, multiSlider->count());
+        if(last == multiSlider->count())
+        {
+            // distance between maximum and last handle
+            ++last;
+        }
     }
-    for(int i = 0;  i < values.size();  i++)
+    for(int i = first;  i < last;  i++)
     {
-        updateSpinBoxValue(i);
+        updateLabel(i);
     }
-    if(showDifferences())
+}
+
+void MultiSliderWidget::onSliderPositionsMoved(int first, int last, const QVector<int>& oldPositions, const QVector<int>& newPositions)
+{
+    if(!showDifferences())
     {
-        spinBoxes.last()->setValue(multiSlider->maximum() - (multiSlider->count() ? multiSlider->positions().last() : multiSlider->minimum()));
+        onSliderPositionsChanged(first, last);
+        return;
     }
-    for (auto spinBox : spinBoxes)
+    // a distance changes only where neighbour handles moved by different shifts,
+    // so for a block of handles shifted together only labels at its edges are updated
+    updateLabel(first);
+    for(int i = first + 1;  i < last;  i++)
     {
-        spinBox->blockSignals(false);
+        const int shift = newPositions.at(i - first) - oldPositions.at(i - first);
+        const int previousShift = newPositions.at(i - first - 1) - oldPositions.at(i - first - 1);
+        if(shift != previousShift)
+        {
+            updateLabel(i);
+        }
+    }
+    // distance after last moved handle, or between maximum and last handle
+    updateLabel(last);
+}
+
+void MultiSliderWidget::onSliderPositionsShifted(int first, int last, int delta)
+{
+    Q_UNUSED(delta);
+    if(!showDifferences())
+    {
+        onSliderPositionsChanged(first, last);
+        return;
     }
+    // distances inside the shifted block stay the same
+    updateLabel(first);
+    updateLabel(last);
 }
 
 void MultiSliderWidget::onSliderRangeChanged(int min, int max)
 {
-    for (auto spinBox : spinBoxes)
+    QList<SpinBox*> editors = spinBoxes;
+    if (labelEditor)
+    {
+        editors.append(labelEditor);
+    }
+    for (auto spinBox : editors)
     {
         spinBox->blockSignals(true);
         spinBox->setMinimum(min);
@@ -283,6 +574,19 @@ void MultiSliderWidget::onSliderRangeChanged(int min, int max)
     }
 }
 
+void MultiSliderWidget::onSliderColorSchemeChanged()
+{
+    for (auto spinBox : spinBoxes)
+    {
+        spinBox->setFocusColor(multiSlider->segmentBackgroundColor(spinBox->index()));
+    }
+    if (labelStrip)
+    {
+        labelEditor->setFocusColor(multiSlider->segmentBackgroundColor(labelEditor->index()));
+        labelStrip->update();
+    }
+}
+
 void MultiSliderWidget::onSpinBoxValueChanged(int value)
 {
     Q_ASSERT(dynamic_cast<SpinBox*>(sender()) != nullptr);
@@ -297,12 +601,11 @@ void MultiSliderWidget::onSpinBoxValueChanged(int value)
         }
         else
         {
-            int sum = 0;
-            for (int i = 0; i <= index; i++)
-            {
-                sum += spinBoxes.at(i)->value();
-            }
-            multiSlider->setValue(index, sum);
+            // handles after edited distance keep their distances; the shift
+            // is lazy, so the edit costs O(log count) and updates two labels
+            multiSlider->shiftValues(index, multiSlider->count(), value - labelValue(index));
+            // shift can be cut by range, label shows the distance which was set
+            updateLabel(index);
         }
     }
     else
@@ -311,21 +614,54 @@ void MultiSliderWidget::onSpinBoxValueChanged(int value)
     }
 }
 
-void MultiSliderWidget::updateSpinBoxValue(int i)
+void MultiSliderWidget::updateLabel(int i)
 {
-    const QVector<int> &positions = multiSlider->positions();
-    if(showDifferences())
+    const int value = labelValue(i);
+    if(labelStrip)
     {
-        spinBoxes.at(i)->setValue(positions.at(i) - (i ? positions.at(i - 1) : multiSlider->minimum()));
+        labelStrip->setValue(i, value);
+        if(labelEditor->isVisible() && labelEditor->index() == i)
+        {
+            labelEditor->blockSignals(true);
+            labelEditor->setValue(value);
+            labelEditor->blockSignals(false);
+        }
+        return;
     }
-    else
+    spinBoxes.at(i)->blockSignals(true);
+    spinBoxes.at(i)->setValue(value);
+    spinBoxes.at(i)->blockSignals(false);
+}
+
+void MultiSliderWidget::editLabel(int index)
+{
+    Q_ASSERT(labelStrip);
+    labelEditor->setIndex(index);
+    labelEditor->setFocusColor(multiSlider->segmentBackgroundColor(index));
+    labelEditor->blockSignals(true);
+    labelEditor->setValue(labelValue(index));
+    labelEditor->blockSignals(false);
+    labelEditor->setGeometry(labelStrip->labelRect(index));
+    labelEditor->show();
+    labelEditor->setFocus();
+    if (index < multiSlider->count())
     {
-        spinBoxes.at(i)->setValue(positions.at(i));
+        labelStrip->setCurrent(index);
     }
 }
 
 void MultiSliderWidget::selectNextSpinBox()
 {
+    if(labelStrip)
+    {
+        if(labelStrip->count() == 0)
+        {
+            return;
+        }
+        const int current = labelEditor->isVisible() ? labelEditor->index() : multiSlider->selectedHandle();
+        editLabel(current + 1 < labelStrip->count() ? current + 1 : 0);
+        return;
+    }
     for(int i = 0; i < spinBoxes.size(); ++i)
     {
         if(spinBoxes.at(i)->hasFocus())
@@ -375,6 +711,11 @@ bool MultiSliderWidget::showDifferences() const
     return m_showDifferences;
 }
 
+bool MultiSliderWidget::paintedLabels() const
+{
+    return labelStrip != nullptr;
+}
+
 void MultiSliderWidget::setLabelsUnder(bool arg)
 {
     if (m_labelsUnder == arg)
@@ -402,8 +743,39 @@ void MultiSliderWidget::setShowDifferences(bool arg)
     
     m_showDifferences = arg;
     onSliderCountChanged(multiSlider->count());
-    onSliderPositionsChanged(multiSlider->positions());
+    onSliderPositionsChanged(0, multiSlider->count());
     emit showDifferencesChanged(arg);
     emit showPositionsChanged(!arg);
 }
 
+
+void MultiSliderWidget::setPaintedLabels(bool arg)
+{
+    if (paintedLabels() == arg)
+        return;
+
+    if (arg)
+    {
+        labelStrip = new LabelStrip(this);
+        labelEditor = createSpinBox(0);
+        labelEditor->setParent(labelStrip);
+        labelEditor->hide();
+        connect(labelEditor, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged), this, &MultiSliderWidget::onSpinBoxValueChanged);
+        connect(labelEditor, &QSpinBox::editingFinished, labelEditor, &QWidget::hide);
+        labelStrip->setFixedHeight(labelEditor->sizeHint().height());
+        labelsLayout->addWidget(labelStrip);
+    }
+    else
+    {
+        delete labelStrip; // editor is deleted as its child
+        labelStrip = nullptr;
+        labelEditor = nullptr;
+    }
+    onSliderCountChanged(multiSlider->count());
+    if (labelStrip)
+    {
+        labelStrip->setCurrent(multiSlider->selectedHandle());
+    }
+    onLabelsUnderChanged();
+    emit paintedLabelsChanged(arg);
+}
@@ -2,6 +2,7 @@
 #define MULTISLIDERWIDGET_H
 
 #include <QFrame>
+#include <QVector>
 
 class MultiSlider;
 class QPushButton;
@@ -9,6 +10,7 @@ class QVBoxLayout;
 class QHBoxLayout;
 class QEvemt;
 class QSignalMapper;
+class QTimer;
 
 class MultiSliderWidget : public QFrame
 {
@@ -16,6 +18,7 @@ class MultiSliderWidget : public QFrame
     Q_PROPERTY(bool labelsUnder READ labelsUnder WRITE setLabelsUnder NOTIFY labelsUnderChanged)
     Q_PROPERTY(bool showPositions READ showPositions WRITE setShowPositions NOTIFY showPositionsChanged)
     Q_PROPERTY(bool showDifferences READ showDifferences WRITE setShowDifferences NOTIFY showDifferencesChanged)
+    Q_PROPERTY(bool paintedLabels READ paintedLabels WRITE setPaintedLabels NOTIFY paintedLabelsChanged)
 
 public:
     MultiSliderWidget(QWidget *parent = 0);
@@ -30,19 +33,28 @@ protected:
 
 private:
     class SpinBox;
+    class LabelStrip;
     SpinBox* createSpinBox(int index);
     void initMultiSlider();
     void createWidget();
-    void updateSpinBoxValue(int i);
+    int labelsCount() const;
+    int labelValue(int i) const;
+    void updateLabel(int i);
     void selectNextSpinBox();
     void onLabelsUnderChanged();
+    void editLabel(int index);
+    void stepHandle(int handle, int delta, bool autoRepeat);
+    void flushKeySteps();
 
 private slots:
     void updateButtonsEnable();
     void onSliderCountChanged(int count);
     void onSelectedHandleChanged(int handle);
-    void onSliderPositionsChanged(QVector<int> values);
+    void onSliderPositionsChanged(int first, int last);
+    void onSliderPositionsMoved(int first, int last, const QVector<int>& oldPositions, const QVector<int>& newPositions);
+    void onSliderPositionsShifted(int first, int last, int delta);
     void onSliderRangeChanged(int min, int max);
+    void onSliderColorSchemeChanged();
     void onSpinBoxValueChanged(int value);
 
 private:
@@ -51,6 +63,15 @@ private:
     QHBoxLayout *widgetLayout;
     MultiSlider *multiSlider;
     QList<SpinBox*> spinBoxes;
+    LabelStrip *labelStrip = nullptr;
+    SpinBox *labelEditor = nullptr;
+    /// key repeats are applied once per frame by this timer
+    QTimer *keyTimer = nullptr;
+    /// handle and sum of steps not applied yet
+    int keyHandle = -1;
+    qint64 keyDelta = 0;
+    /// auto repeats of held key, steps grow with them
+    int keyRepeats = 0;
     QPushButton *addToLeftButton;
     QPushButton *addToRightButton;
     QPushButton *removeFromLeftButton;
@@ -61,16 +82,19 @@ public:
     bool labelsUnder() const;
     bool showPositions() const;
     bool showDifferences() const;
+    bool paintedLabels() const;
 
 public slots:
     void setLabelsUnder(bool arg);
     void setShowPositions(bool arg);
     void setShowDifferences(bool arg);
+    void setPaintedLabels(bool arg);
     
 signals:
     void labelsUnderChanged(bool arg);
     void showPositionsChanged(bool arg);
     void showDifferencesChanged(bool arg);
+    void paintedLabelsChanged(bool arg);
     
 private:
     bool m_labelsUnder = false;
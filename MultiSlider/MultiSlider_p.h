@@ -1,18 +1,144 @@
 #ifndef __MULTISLIDER_P_H__
 #define __MULTISLIDER_P_H__
 
-#include <QObject>
+#include <QBrush>
+#include <QColor>
+#include <QHash>
+#include <QPair>
+#include <QPen>
+#include <QPixmap>
+#include <QRect>
+#include <QScopedPointer>
+#include <QSize>
+#include <QSlider>
+#include <QStyle>
+#include <QTimer>
+#include <QVarLengthArray>
+#include <QVector>
 
-class MultiSliderPrivate : public QObject
+#include "MultiSliderJournal.h"
+#include "MultiSliderModel.h"
+#include "MultiSliderSnapIndex.h"
+#include "MultiSliderSnapshot.h"
+#include "MultiSliderStats.h"
+
+/// Plain class, not a QObject, so a slider does not pay for a second QObject
+class MultiSliderPrivate
 {
     Q_DECLARE_PUBLIC(MultiSlider)
 protected:
     MultiSlider* const q_ptr;
 
 public:
+    /// Style dependent slider geometry.
+    /// QStyle is asked only when this geometry is rebuilt, all hot paths read from it.
+    struct Geometry
+    {
+        /// groove rect
+        QRect groove;
+        /// handle rect, moved along the slider by handleRect()
+        QRect handle;
+        /// offset between pixel position of a value and the start of its handle rect
+        int handleOffset = 0;
+        /// see QSliderPrivate::pixelPosToRangeValue
+        int sliderMin = 0;
+        int span = 0;
+        /// PM_SliderSpaceAvailable, the length ticks are drawn along
+        int spaceAvailable = 0;
+        bool upsideDown = false;
+        /// style()->objectName() == "macintosh"
+        bool isMac = false;
+
+        /// properties geometry was built for.
+        /// QSlider do not notify about most of them, so they are compared on each access
+        bool valid = false;
+        Qt::Orientation orientation = Qt::Horizontal;
+        bool invertedAppearance = false;
+        QSlider::TickPosition tickPosition = QSlider::NoTicks;
+        int minimum = 0;
+        int maximum = 0;
+        /// hidden widget gets resize event only when it is shown
+        QSize size;
+    };
+
+    /// Precomputed drawing tools for one color of the color scheme
+    struct SegmentPalette
+    {
+        /// segment fill
+        QBrush brush;
+        /// segment outline
+        QPen pen;
+        /// light variant of the color, used for labels
+        QColor background;
+    };
+
+    /// Look of a pre-rendered handle: fields of its style option except position.
+    /// initSliderStyleOption can style each handle differently, so every field
+    /// styles draw a handle from is compared, not only state and palette.
+    struct SpriteKey
+    {
+        QStyle::State state;
+        QStyle::SubControls activeSubControls;
+        qint64 paletteKey;
+        QSize size;
+        Qt::Orientation orientation;
+        QSlider::TickPosition tickPosition;
+        bool upsideDown;
+        Qt::LayoutDirection direction;
+
+        bool operator==(const SpriteKey& other) const
+        {
+            return state == other.state
+                    && activeSubControls == other.activeSubControls
+                    && paletteKey == other.paletteKey
+                    && size == other.size
+                    && orientation == other.orientation
+                    && tickPosition == other.tickPosition
+                    && upsideDown == other.upsideDown
+                    && direction == other.direction;
+        }
+
+        /// hashes the fields which usually differ, equal keys are told apart by operator==
+        friend uint qHash(const SpriteKey& key, uint seed = 0)
+        {
+            return qHash((quint64(uint(key.state)) << 32) | uint(key.activeSubControls), seed)
+                    ^ qHash(key.paletteKey)
+                    ^ qHash((quint64(uint(key.size.width())) << 32) | uint(key.size.height()));
+        }
+    };
+
     MultiSliderPrivate(MultiSlider& object);
+    /// subclasses of MultiSlider can pass their own private classes
+    virtual ~MultiSliderPrivate() = default;
     void init();
 
+    /// \brief set colors of segments and rebuild m_palette
+    /// \note empty colors means default scheme, see MultiSlider::color
+    void setColorScheme(const QVector<QColor>& colors);
+
+    /// \brief returns cached geometry, rebuild it if slider properties were changed
+    const Geometry& geometry() const;
+
+    /// \brief drop cached geometry. Called on resize, style and layout direction change
+    void invalidateGeometry();
+
+    /// \brief handle rect for given value
+    QRect handleRect(int value) const;
+
+    /// \brief returns range [first, second) of handles which rects intersect given pixel span
+    /// \param from first pixel along the slider
+    /// \param to last pixel along the slider
+    QPair<int, int> handlesInSpan(int from, int to) const;
+
+    /// \brief repaint handles [first, last) and colored segments around them
+    void updateHandles(int first, int last);
+
+    /// \brief repaint one handle
+    void updateHandle(int index);
+
+    /// \brief repaint whole slider height (or width for vertical slider) along given rect
+    void updateSpan(const QRect& rect);
+
     /// \brief function return first handle at given pos.
     /// \param[in]  pos given position
     /// \param[out] if handle was found param is equal to founded handle rect. Otherwise return empty rect
@@ -26,6 +152,10 @@ public:
     ///
     int posBetweenHandles(QPoint pos) const;
 
+    /// \brief interval between drawn ticks, the rule is copied from QCommonStyle::drawComplexControl:
+    /// tickInterval, or singleStep if it is 0, or pageStep if singleStep ticks are closer than 3 pixels
+    int tickInterval() const;
+
     /// Copied verbatim from QSliderPrivate class (see QSlider.cpp)
     int pixelPosToRangeValue(int pos) const;
     int pixelPosFromRangeValue(int val) const;
@@ -35,11 +165,34 @@ public:
     /// \param[in]  painter painter to draw handle
     void drawHandle(int num, QStylePainter* painter) const;
 
-    /// Values on slider
-    QVector<int> m_values;
+    /// \brief rect of colored segment between two positions
+    QRect segmentRect(int pos, int nextPos) const;
+
+    /// \brief index in m_palette of segment color
+    /// \param segment  segment index, segment i lies between handles i - 1 and i
+    int segmentColorIndex(int segment) const;
+
+    /// \brief clear segments collected for drawSegments
+    void clearSegments();
 
-    /// Positions on slider.
-    QVector<int> m_positions;
+    /// \brief segments to be drawn with color at given index in m_palette
+    QVector<QRect>& segmentsOfColor(int colorIndex);
+
+    /// \brief draw collected segments, one call for each color
+    void drawSegments(QStylePainter* painter);
+
+    /// \brief draw slider with more handles than pixels in given span.
+    /// Each pixel shows one segment and density of handles in it,
+    /// handles are drawn only where they have room.
+    /// \param from first pixel along the slider
+    /// \param to last pixel along the slider
+    void drawLevelOfDetail(QStylePainter* painter, int from, int to);
+
+    /// \brief drop pre-rendered handles, see drawHandle
+    void clearHandleSprites();
+
+    /// positions, values and constraints of handles
+    MultiSliderModel m_model;
 
     /// See QSliderPrivate::clickOffset.
     /// Overrides this var
@@ -52,20 +205,74 @@ public:
     /// Original width between the 2 bounds before any moves
     float m_subclassWidth;
 
-    /// vector of selected handles numbers
-    QVector<int> m_selectedHandles;
+    /// numbers of selected handles, at most two
+    QVarLengthArray<int, 2> m_selectedHandles;
 
     /// tooltip to be displayed on handle
     QString m_handleToolTip;
 
-    /// count of slider handles
-    int m_count;
-    /// maximum available count of handles
-    int m_maxCount;
-    /// minimum range between handles
-    int m_minimumRange;
+    /// colors of segments
+    QVector<QColor> m_colorScheme;
+    /// drawing tools for each color of m_colorScheme
+    QVector<SegmentPalette> m_palette;
+
+    /// colored segments by color, reused between paint events
+    QVector<QVector<QRect>> m_segmentRects;
+
+    /// draw density of handles instead of each handle when there are more handles than pixels
+    bool m_levelOfDetail;
+
+    /// emit positionsChanged and valuesChanged with all positions
+    bool m_fullVectorSignals;
+
+    /// new positions and values of range signals, reused so signals do not allocate
+    QVector<int> m_signalPositions;
+    QVector<int> m_signalValues;
+
+    /// count of nested transactions, see MultiSlider::beginTransaction
+    int m_transactionDepth;
+    /// values were set inside transaction, so they are committed with it
+    bool m_transactionValues;
+    /// a level of transaction was begun without undo, so its commit is not recorded
+    bool m_transactionWithoutUndo;
+
+    /// snap to ticks, grid and markers, see MultiSlider::snapToTicks
+    bool m_snapToTicks;
+    int m_snapGrid;
+    int m_snapDistance;
+    MultiSliderSnapIndex m_snapIndex;
+
+    /// undo history, null while undo is disabled
+    QScopedPointer<MultiSliderJournal> m_journal;
+    /// values are changed by undo or redo, so they are not recorded
+    bool m_applyingJournal;
+
+    /// values for reader thread, created by MultiSlider::valuesSnapshot
+    QScopedPointer<MultiSliderSnapshot> m_snapshot;
+
+    /// hot path counters, null while stats are disabled
+    QScopedPointer<MultiSliderStats> m_stats;
+    /// periodic output of m_stats
+    QTimer m_statsTimer;
+
+    /// process mouse moves once per frame, see MultiSlider::dragCoalescing
+    bool m_dragCoalescing;
+    /// mouse position waiting for m_dragTimer
+    bool m_dragPending;
+    int m_pendingDragPos;
+    QTimer m_dragTimer;
 
 private:
+    void rebuildGeometry() const;
+
+    /// cached geometry, see geometry()
+    mutable Geometry m_geometry;
+
+    /// pre-rendered handles by look, see drawHandle
+    mutable QHash<SpriteKey, QPixmap> m_handleSprites;
+    /// device pixel ratio of m_handleSprites
+    mutable qreal m_spriteDevicePixelRatio;
+
     Q_DISABLE_COPY(MultiSliderPrivate)
 };
 
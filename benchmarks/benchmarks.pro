@@ -0,0 +1,21 @@
+#-------------------------------------------------
+#
+# MultiSlider benchmarks.
+# Run headless and write machine-readable results, e.g.
+#   ./benchmarks -o results.csv,csv
+#   ./benchmarks -o results.xml,xml
+#
+#-------------------------------------------------
+
+QT       += core gui testlib
+
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
+
+TARGET = benchmarks
+TEMPLATE = app
+CONFIG += console testcase
+CONFIG -= app_bundle
+
+include(../MultiSlider/MultiSlider.pri)
+
+SOURCES += tst_benchmarks.cpp
@@ -0,0 +1,305 @@
+#include <QApplication>
+#include <QImage>
+#include <QtTest>
+
+#include <algorithm>
+
+#include "MultiSlider.h"
+#include "MultiSlider_p.h"
+#include "MultiSliderAutomation.h"
+#include "MultiSliderSolver.h"
+
+namespace
+{
+/// pixels between handles when slider is filled by setUp
+const int Spacing = 10;
+/// length of slider in pixels
+const int Length = 1000;
+/// count of hit tests in one benchmark iteration
+const int HitTests = 100;
+
+/// gives access to protected and private parts of the slider
+class BenchmarkSlider : public MultiSlider
+{
+public:
+    BenchmarkSlider()
+        : MultiSlider(Qt::Horizontal)
+    {
+    }
+
+    MultiSliderPrivate* d() const
+    {
+        return d_ptr.data();
+    }
+};
+}
+
+class Benchmarks : public QObject
+{
+    Q_OBJECT
+
+private:
+    /// \brief add count column with rows for each benchmarked count of handles
+    void addCounts();
+
+    /// \brief set range and count of handles, handles are placed at minimum range from each other
+    void setUp(BenchmarkSlider& slider, int count);
+
+private Q_SLOTS:
+    void setPositionCascade_data();
+    void setPositionCascade();
+    void normalize_data();
+    void normalize();
+    void addRemoveLeft_data();
+    void addRemoveLeft();
+    void handleAtPos_data();
+    void handleAtPos();
+    void posBetweenHandles_data();
+    void posBetweenHandles();
+    void paintEvent_data();
+    void paintEvent();
+    void smallCountNormalize_data();
+    void smallCountNormalize();
+    void automationTick_data();
+    void automationTick();
+    void snapMarkers_data();
+    void snapMarkers();
+};
+
+void Benchmarks::addCounts()
+{
+    QTest::addColumn<int>("count");
+    QTest::newRow("3") << 3;
+    QTest::newRow("100") << 100;
+    QTest::newRow("10k") << 10000;
+    QTest::newRow("100k") << 100000;
+}
+
+void Benchmarks::setUp(BenchmarkSlider& slider, int count)
+{
+    slider.resize(Length, 30);
+    // half of range stays free to let handles be pushed
+    slider.setRange(0, 2 * Spacing * (count + 1));
+    slider.setMinimumRange(Spacing);
+    slider.setCount(count);
+    QCOMPARE(slider.count(), count);
+}
+
+void Benchmarks::setPositionCascade_data()
+{
+    addCounts();
+}
+
+void Benchmarks::setPositionCascade()
+{
+    QFETCH(int, count);
+    BenchmarkSlider slider;
+    setUp(slider, count);
+    // first handle pushes all others to maximum, then last one pushes them back
+    QBENCHMARK
+    {
+        slider.setPosition(0, slider.maximum());
+        slider.setPosition(count - 1, slider.minimum());
+    }
+}
+
+void Benchmarks::normalize_data()
+{
+    addCounts();
+}
+
+void Benchmarks::normalize()
+{
+    QFETCH(int, count);
+    BenchmarkSlider slider;
+    setUp(slider, count);
+    // each change of minimum range moves all handles
+    QBENCHMARK
+    {
+        slider.setMinimumRange(Spacing + 1);
+        slider.setMinimumRange(Spacing);
+    }
+}
+
+void Benchmarks::addRemoveLeft_data()
+{
+    addCounts();
+}
+
+void Benchmarks::addRemoveLeft()
+{
+    QFETCH(int, count);
+    BenchmarkSlider slider;
+    setUp(slider, count);
+    QBENCHMARK
+    {
+        slider.addToLeft(1);
+        slider.removeFromLeft(1);
+    }
+}
+
+void Benchmarks::handleAtPos_data()
+{
+    addCounts();
+}
+
+void Benchmarks::handleAtPos()
+{
+    QFETCH(int, count);
+    BenchmarkSlider slider;
+    setUp(slider, count);
+    const int y = slider.height() / 2;
+    int found = 0;
+    QRect rect;
+    QBENCHMARK
+    {
+        for (int i = 0; i < HitTests; ++i)
+        {
+            found += slider.d()->handleAtPos(QPoint(i * Length / HitTests, y), rect) != -1;
+        }
+    }
+    QVERIFY(found >= 0);
+}
+
+void Benchmarks::posBetweenHandles_data()
+{
+    addCounts();
+}
+
+void Benchmarks::posBetweenHandles()
+{
+    QFETCH(int, count);
+    BenchmarkSlider slider;
+    setUp(slider, count);
+    const int y = slider.height() / 2;
+    int found = 0;
+    QBENCHMARK
+    {
+        for (int i = 0; i < HitTests; ++i)
+        {
+            found += slider.d()->posBetweenHandles(QPoint(i * Length / HitTests, y)) != -1;
+        }
+    }
+    QVERIFY(found >= 0);
+}
+
+void Benchmarks::paintEvent_data()
+{
+    addCounts();
+}
+
+void Benchmarks::paintEvent()
+{
+    QFETCH(int, count);
+    BenchmarkSlider slider;
+    setUp(slider, count);
+    QImage image(slider.size(), QImage::Format_ARGB32_Premultiplied);
+    QBENCHMARK
+    {
+        slider.render(&image);
+    }
+}
+
+void Benchmarks::smallCountNormalize_data()
+{
+    QTest::addColumn<bool>("fixed");
+    QTest::newRow("fixed") << true;
+    QTest::newRow("dynamic") << false;
+}
+
+void Benchmarks::smallCountNormalize()
+{
+    QFETCH(bool, fixed);
+    const MultiSliderSolver::Constraints constraints{ 0, 8 * Spacing, Spacing };
+    // count of handles of the widget's range slider, all of them violate constraints
+    const int unordered[] = { 8 * Spacing, 4 * Spacing, 0 };
+    // keeps count unknown to compiler for dynamic row
+    volatile int count = 3;
+    int positions[3];
+    const auto replace = [&positions](int i, int position) {
+        positions[i] = position;
+    };
+    QBENCHMARK
+    {
+        std::copy(unordered, unordered + 3, positions);
+        if (fixed)
+        {
+            MultiSliderSolver::FixedCount<MultiSliderModel::InlineCount>::normalize(positions, count, constraints, replace);
+        }
+        else
+        {
+            MultiSliderSolver::normalize(positions, count, constraints, replace);
+        }
+    }
+    QCOMPARE(positions[0], 5 * Spacing);
+    QCOMPARE(positions[2], 7 * Spacing);
+}
+
+void Benchmarks::automationTick_data()
+{
+    addCounts();
+}
+
+void Benchmarks::automationTick()
+{
+    QFETCH(int, count);
+    BenchmarkSlider slider;
+    setUp(slider, count);
+    // each handle sweeps over its free space and back, so neighbours push each other
+    MultiSliderAutomation automation(&slider);
+    for (int i = 0; i < count; ++i)
+    {
+        const int value = slider.value(i);
+        automation.setCurve(i, { { 0, value }, { 500, value + Spacing * (i % 3) }, { 1000, value } });
+    }
+    automation.setLooping(true);
+    qint64 time = 0;
+    QBENCHMARK
+    {
+        time += 16;
+        automation.setTime(time);
+    }
+}
+
+void Benchmarks::snapMarkers_data()
+{
+    addCounts();
+}
+
+void Benchmarks::snapMarkers()
+{
+    QFETCH(int, count);
+    BenchmarkSlider slider;
+    setUp(slider, count);
+    // markers are denser than handles, so each move resolves to a different one
+    const int markersCount = 100000;
+    QVector<int> markers(markersCount);
+    for (int i = 0; i < markersCount; ++i)
+    {
+        markers[i] = int(qint64(slider.maximum()) * i / markersCount) + 1;
+    }
+    slider.setSnapMarkers(markers);
+    const int middle = count / 2;
+    const int from = slider.position(middle);
+    int shift = 0;
+    QBENCHMARK
+    {
+        shift = (shift + 7) % Spacing;
+        slider.setPosition(middle, from + shift);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    // benchmarks do not need a display
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+    {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    Q_INIT_RESOURCE(res);
+    QApplication app(argc, argv);
+    Benchmarks benchmarks;
+    return QTest::qExec(&benchmarks, argc, argv);
+}
+
+#include "tst_benchmarks.moc"
@@ -0,0 +1,16 @@
+#-------------------------------------------------
+#
+# MultiSlider demo application
+#
+#-------------------------------------------------
+
+QT       += core gui
+
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
+
+TARGET = MultiSlider
+TEMPLATE = app
+
+include(../MultiSlider/MultiSlider.pri)
+
+SOURCES += main.cpp
@@ -1,8 +1,9 @@
 #include <QApplication>
-#include "MultiSlider/MultiSliderWidget.h"
+#include "MultiSliderWidget.h"
 
 int main(int argc, char *argv[])
 {
+    Q_INIT_RESOURCE(res);
     QApplication a(argc, argv);
     MultiSliderWidget w;
     w.show();
@@ -0,0 +1,19 @@
+#-------------------------------------------------
+#
+# MultiSlider unit tests, run headless:
+#   ./tests
+#
+#-------------------------------------------------
+
+QT       += core gui testlib
+
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
+
+TARGET = tests
+TEMPLATE = app
+CONFIG += console testcase
+CONFIG -= app_bundle
+
+include(../MultiSlider/MultiSlider.pri)
+
+SOURCES += tst_multislider.cpp
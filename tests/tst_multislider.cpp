@@ -0,0 +1,757 @@
+#include <QApplication>
+#include <QBuffer>
+#include <QSignalSpy>
+#include <QThread>
+#include <QtTest>
+
+#include <algorithm>
+#include <limits>
+#include <random>
+
+#include "MultiSlider.h"
+#include "MultiSliderAutomation.h"
+#include "MultiSliderJournal.h"
+#include "MultiSliderModel.h"
+#include "MultiSliderRecording.h"
+#include "MultiSliderSnapshot.h"
+
+namespace
+{
+/// movePosition of the recursive solver normalize was built on before it became linear
+void referenceMove(QVector<int>& positions, int minimum, int maximum, int minimumRange, int index, int arg)
+{
+    const int position = positions.at(index);
+    if (index == (arg < 0 ? 0 : positions.size() - 1))
+    {
+        positions[index] = qBound(minimum + minimumRange, position + arg, maximum - minimumRange);
+        return;
+    }
+    const int nextStep = arg < 0 ? -1 : 1;
+    const int range = minimumRange * nextStep;
+    const int nextPosition = positions.at(index + nextStep);
+    if (qAbs(arg) < qAbs(position - nextPosition + range))
+    {
+        positions[index] = position + arg;
+    }
+    else
+    {
+        referenceMove(positions, minimum, maximum, minimumRange, index + nextStep, arg - (nextPosition - position) + range);
+        positions[index] = positions.at(index + nextStep) - range;
+    }
+}
+
+/// normalize as it was before it became linear: forward and backward passes of movePosition
+void referenceNormalize(QVector<int>& positions, int minimum, int maximum, int minimumRange)
+{
+    const int count = positions.size();
+    if (count == 0)
+    {
+        return;
+    }
+    for (int i = -1; i < count - 1; ++i)
+    {
+        const int diff = i == -1 ? positions.first() - minimum : positions.at(i + 1) - positions.at(i);
+        if (diff < minimumRange)
+        {
+            referenceMove(positions, minimum, maximum, minimumRange, i + 1, minimumRange - diff);
+        }
+    }
+    for (int i = count; i > 0; --i)
+    {
+        const int diff = i == count ? maximum - positions.last() : positions.at(i) - positions.at(i - 1);
+        if (diff < minimumRange)
+        {
+            referenceMove(positions, minimum, maximum, minimumRange, i - 1, minimumRange - diff);
+        }
+    }
+}
+
+/// \brief set slider range to [0, 100] and place handles at given values
+void initSlider(MultiSlider& slider, const QVector<int>& values, int minimumRange = 0)
+{
+    slider.setRange(0, 100);
+    slider.setMinimumRange(minimumRange);
+    slider.setCount(values.size());
+    slider.setValues(values);
+}
+
+/// \brief set values [first, first + count) and record the change to journal
+void recordChange(MultiSliderJournal& journal, QVector<int>& values, int first, const QVector<int>& newValues)
+{
+    const QVector<int> oldValues = values.mid(first, newValues.size());
+    std::copy(newValues.constBegin(), newValues.constEnd(), values.begin() + first);
+    journal.record(first, oldValues, values.constData());
+}
+
+/// \brief restore values changed by the last step of journal
+void undoChange(MultiSliderJournal& journal, QVector<int>& values)
+{
+    const MultiSliderJournal::Entry& entry = journal.undo();
+    std::copy(entry.oldValues.constBegin(), entry.oldValues.constEnd(), values.begin() + entry.first);
+}
+
+/// \brief apply the last undone step of journal again
+void redoChange(MultiSliderJournal& journal, QVector<int>& values)
+{
+    const MultiSliderJournal::Entry& entry = journal.redo();
+    std::copy(entry.newValues.constBegin(), entry.newValues.constEnd(), values.begin() + entry.first);
+}
+
+/// \brief memory used by journal entry of count values
+int journalEntrySize(int count)
+{
+    return int(sizeof(MultiSliderJournal::Entry)) + 2 * count * int(sizeof(int));
+}
+
+/// range, minimum range and values of slider, compared by recording tests
+struct SliderState
+{
+    int minimum;
+    int maximum;
+    int minimumRange;
+    QVector<int> values;
+
+    bool operator==(const SliderState& other) const
+    {
+        return minimum == other.minimum && maximum == other.maximum
+                && minimumRange == other.minimumRange && values == other.values;
+    }
+};
+
+SliderState sliderState(const MultiSlider& slider)
+{
+    return { slider.minimum(), slider.maximum(), slider.minimumRange(), slider.values() };
+}
+
+/// count of snapshots published while reader thread reads them
+const int SnapshotsPublished = 100000;
+
+/// reads snapshots until the last published one, checks that each read sees values of one publish
+class SnapshotReader : public QThread
+{
+public:
+    explicit SnapshotReader(MultiSliderSnapshot& snapshot)
+        : m_snapshot(snapshot)
+        , m_reads(0)
+        , m_torn(0)
+        , m_backward(0)
+    {
+    }
+
+    int reads() const
+    {
+        return m_reads;
+    }
+
+    /// reads with values of different publishes
+    int torn() const
+    {
+        return m_torn;
+    }
+
+    /// reads older than the previous one
+    int backward() const
+    {
+        return m_backward;
+    }
+
+protected:
+    void run() override
+    {
+        int values[4];
+        int last = -1;
+        while (last != SnapshotsPublished - 1)
+        {
+            if (!m_snapshot.hasUpdate())
+            {
+                continue;
+            }
+            const int count = m_snapshot.read(values, 4);
+            ++m_reads;
+            // publish k has k % 4 + 1 values equal to k
+            if (count != values[0] % 4 + 1 || !std::all_of(values, values + count, [&values](int value) { return value == values[0]; }))
+            {
+                ++m_torn;
+            }
+            if (values[0] < last)
+            {
+                ++m_backward;
+            }
+            last = values[0];
+        }
+    }
+
+private:
+    MultiSliderSnapshot& m_snapshot;
+    int m_reads;
+    int m_torn;
+    int m_backward;
+};
+}
+
+class Tests : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void normalizeMatchesReference();
+    void snapKeepsMinimumRange();
+    void stepMovesToNextSnapTarget();
+    void snapToTicksFollowsStyleInterval();
+    void setValueSnapsInTransaction();
+    void snapshotReadsLatestPublish();
+    void snapshotFollowsCommits();
+    void snapshotReadWhilePublishing();
+    void transactionCommitsOnOutermostLevel();
+    void transactionGuardCommitsOnScopeExit();
+    void transactionIsOneUndoStep();
+    void shiftValuesEmitsShiftSignals();
+    void shiftValuesIsOneUndoStep();
+    void journalUndoRedoRoundTrip();
+    void journalMergesDrag();
+    void journalTrimsOldestSteps();
+    void journalKeepsLastStepOverLimit();
+    void automationInterpolatesCurves();
+    void automationStaysOutOfUndo();
+    void recordingReplaysEachState();
+};
+
+void Tests::normalizeMatchesReference()
+{
+    std::mt19937 random(1);
+    for (int run = 0; run < 20000; ++run)
+    {
+        const int minimum = int(random() % 21) - 10;
+        const int maximum = minimum + int(random() % 200) + 10;
+        const int minimumRange = int(random() % 6);
+
+        MultiSliderModel model;
+        model.setRange(minimum, maximum);
+        model.setMinimumRange(minimumRange);
+        model.refreshMaxCount();
+        // count never exceeds maxCount, the slider keeps it so
+        model.addToRight(int(random() % 20) + 1);
+        model.normalize();
+        const int count = model.count();
+
+        // sorted and unsorted positions, some of them out of range
+        QVector<int> positions(count);
+        for (int& position : positions)
+        {
+            position = minimum - 20 + int(random() % (maximum - minimum + 40));
+        }
+        if (random() % 2)
+        {
+            std::sort(positions.begin(), positions.end());
+        }
+
+        QVector<int> expected = positions;
+        referenceNormalize(expected, minimum, maximum, minimumRange);
+
+        model.beginStaging();
+        for (int i = 0; i < count; ++i)
+        {
+            model.stagePosition(i, positions.at(i));
+        }
+        model.endStaging();
+        const MultiSliderModel::Handles& normalized = model.positions();
+        QCOMPARE(QVector<int>(normalized.constBegin(), normalized.constEnd()), expected);
+    }
+}
+
+void Tests::snapKeepsMinimumRange()
+{
+    MultiSlider slider(Qt::Horizontal);
+    initSlider(slider, { 30, 50, 70 }, 10);
+    // markers at 5 and 95 are closer to the ends than minimum range
+    slider.setSnapMarkers({ 5, 12, 88, 95 });
+    slider.setSnapDistance(10);
+
+    slider.setPosition(0, 6);
+    QCOMPARE(slider.position(0), 12);
+
+    slider.setPosition(2, 94);
+    QCOMPARE(slider.position(2), 88);
+    QCOMPARE(slider.values(), QVector<int>({ 12, 50, 88 }));
+}
+
+void Tests::stepMovesToNextSnapTarget()
+{
+    MultiSlider slider(Qt::Horizontal);
+    initSlider(slider, { 20 });
+    slider.setSnapGrid(10);
+
+    // short move snaps back to the same target
+    slider.setPosition(0, 21);
+    QCOMPARE(slider.position(0), 20);
+
+    slider.stepPosition(0, 1);
+    QCOMPARE(slider.position(0), 30);
+    slider.stepPosition(0, -1);
+    QCOMPARE(slider.position(0), 20);
+}
+
+void Tests::snapToTicksFollowsStyleInterval()
+{
+    MultiSlider slider(Qt::Horizontal);
+    slider.resize(1000, 30);
+    initSlider(slider, { 50 });
+    slider.setSingleStep(5);
+    slider.setPageStep(20);
+    slider.setSnapToTicks(true);
+
+    // without tickInterval ticks are drawn by singleStep while they are far enough apart
+    slider.setPosition(0, 12);
+    QCOMPARE(slider.position(0), 10);
+
+    // ticks by singleStep would be closer than 3 pixels, so they are drawn by pageStep
+    slider.setSingleStep(1);
+    slider.resize(100, 30);
+    slider.setPosition(0, 27);
+    QCOMPARE(slider.position(0), 20);
+
+    slider.setTickInterval(25);
+    slider.setPosition(0, 40);
+    QCOMPARE(slider.position(0), 50);
+}
+
+void Tests::setValueSnapsInTransaction()
+{
+    MultiSlider slider(Qt::Horizontal);
+    initSlider(slider, { 20, 60 });
+    slider.setSnapGrid(10);
+
+    slider.setValue(0, 33);
+    QCOMPARE(slider.value(0), 30);
+    {
+        MultiSliderTransaction transaction(&slider);
+        slider.setValue(1, 77);
+    }
+    QCOMPARE(slider.value(1), 80);
+
+    // vectors and shifts are exact both inside and outside transaction
+    slider.setValues({ 21, 61 });
+    QCOMPARE(slider.values(), QVector<int>({ 21, 61 }));
+    {
+        MultiSliderTransaction transaction(&slider);
+        slider.setValues({ 23, 63 });
+        slider.shiftValues(0, 2, 1);
+    }
+    QCOMPARE(slider.values(), QVector<int>({ 24, 64 }));
+}
+
+void Tests::snapshotReadsLatestPublish()
+{
+    MultiSliderSnapshot snapshot;
+    int values[2] = { -1, -1 };
+    QVERIFY(!snapshot.hasUpdate());
+    QCOMPARE(snapshot.read(values, 2), 0);
+
+    const int first[] = { 1, 2, 3 };
+    const int second[] = { 4, 5 };
+    snapshot.publish(first, 3);
+    snapshot.publish(second, 2);
+    QVERIFY(snapshot.hasUpdate());
+    QCOMPARE(snapshot.read(values, 2), 2);
+    QCOMPARE(values[0], 4);
+    QCOMPARE(values[1], 5);
+    // dirty flag is cleared by read, the read snapshot stays readable
+    QVERIFY(!snapshot.hasUpdate());
+    values[0] = values[1] = -1;
+    QCOMPARE(snapshot.read(values, 2), 2);
+    QCOMPARE(values[1], 5);
+
+    // values above capacity are not copied, count is returned anyway
+    snapshot.publish(first, 3);
+    QCOMPARE(snapshot.read(values, 2), 3);
+    QCOMPARE(values[0], 1);
+    QCOMPARE(values[1], 2);
+}
+
+void Tests::snapshotFollowsCommits()
+{
+    MultiSlider slider(Qt::Horizontal);
+    initSlider(slider, { 20, 50, 80 });
+    MultiSliderSnapshot* snapshot = slider.valuesSnapshot();
+    int values[3];
+    QCOMPARE(snapshot->read(values, 3), 3);
+    QCOMPARE(QVector<int>(values, values + 3), slider.values());
+
+    slider.setValue(1, 60);
+    QVERIFY(snapshot->hasUpdate());
+    snapshot->read(values, 3);
+    QCOMPARE(values[1], 60);
+
+    slider.setCount(2);
+    QCOMPARE(snapshot->read(values, 3), 2);
+    QCOMPARE(QVector<int>(values, values + 2), slider.values());
+}
+
+void Tests::snapshotReadWhilePublishing()
+{
+    MultiSliderSnapshot snapshot;
+    SnapshotReader reader(snapshot);
+    reader.start();
+    QVector<int> values;
+    for (int k = 0; k < SnapshotsPublished; ++k)
+    {
+        values.fill(k, k % 4 + 1);
+        snapshot.publish(values.constData(), values.size());
+    }
+    QVERIFY(reader.wait(10000));
+    QVERIFY(reader.reads() > 0);
+    QCOMPARE(reader.torn(), 0);
+    QCOMPARE(reader.backward(), 0);
+}
+
+void Tests::transactionCommitsOnOutermostLevel()
+{
+    MultiSlider slider(Qt::Horizontal);
+    initSlider(slider, { 20, 50, 80 }, 10);
+    QSignalSpy rangeSpy(&slider, &MultiSlider::valuesRangeChanged);
+    QSignalSpy updateSpy(&slider, &MultiSlider::valuesUpdated);
+
+    slider.beginTransaction();
+    slider.setValue(0, 30);
+    slider.beginTransaction();
+    slider.setValue(2, 60);
+    slider.commitTransaction();
+    // inner commit does not apply edits
+    QVERIFY(slider.isInTransaction());
+    QCOMPARE(slider.values(), QVector<int>({ 20, 50, 80 }));
+    QCOMPARE(rangeSpy.count(), 0);
+    slider.commitTransaction();
+
+    QVERIFY(!slider.isInTransaction());
+    QCOMPARE(slider.values(), QVector<int>({ 30, 50, 60 }));
+    QCOMPARE(rangeSpy.count(), 1);
+    QCOMPARE(updateSpy.count(), 1);
+    const QList<QVariant> arguments = rangeSpy.takeFirst();
+    QCOMPARE(arguments.at(0).toInt(), 0);
+    QCOMPARE(arguments.at(1).toInt(), 3);
+    QCOMPARE(arguments.at(2).value<QVector<int>>(), QVector<int>({ 20, 50, 80 }));
+    QCOMPARE(arguments.at(3).value<QVector<int>>(), QVector<int>({ 30, 50, 60 }));
+}
+
+void Tests::transactionGuardCommitsOnScopeExit()
+{
+    MultiSlider slider(Qt::Horizontal);
+    initSlider(slider, { 20, 50, 80 }, 10);
+    QSignalSpy rangeSpy(&slider, &MultiSlider::valuesRangeChanged);
+    {
+        MultiSliderTransaction transaction(&slider);
+        slider.setValues({ 10, 40, 70 });
+        slider.shiftValues(1, 3, 5);
+        QCOMPARE(slider.values(), QVector<int>({ 20, 50, 80 }));
+    }
+    QVERIFY(!slider.isInTransaction());
+    QCOMPARE(slider.values(), QVector<int>({ 10, 45, 75 }));
+    QCOMPARE(rangeSpy.count(), 1);
+}
+
+void Tests::transactionIsOneUndoStep()
+{
+    MultiSlider slider(Qt::Horizontal);
+    initSlider(slider, { 20, 50, 80 }, 10);
+    slider.setUndoLimit(1024);
+    {
+        MultiSliderTransaction transaction(&slider);
+        slider.setValue(0, 10);
+        slider.setValue(2, 90);
+    }
+    QVERIFY(slider.canUndo());
+    slider.undo();
+    QCOMPARE(slider.values(), QVector<int>({ 20, 50, 80 }));
+    QVERIFY(!slider.canUndo());
+    slider.redo();
+    QCOMPARE(slider.values(), QVector<int>({ 10, 50, 90 }));
+    QVERIFY(!slider.canRedo());
+}
+
+void Tests::shiftValuesEmitsShiftSignals()
+{
+    MultiSlider slider(Qt::Horizontal);
+    initSlider(slider, { 10, 20, 30, 40, 50 }, 5);
+    QSignalSpy rangeSpy(&slider, &MultiSlider::valuesRangeChanged);
+    QSignalSpy positionsRangeSpy(&slider, &MultiSlider::positionsRangeChanged);
+    QSignalSpy shiftSpy(&slider, &MultiSlider::valuesShifted);
+    QSignalSpy positionsShiftSpy(&slider, &MultiSlider::positionsShifted);
+    QSignalSpy updateSpy(&slider, &MultiSlider::valuesUpdated);
+
+    // shift is cut by maximum and minimum range
+    slider.shiftValues(2, 5, 60);
+    QCOMPARE(slider.value(4), 95);
+    QCOMPARE(slider.value(1), 20);
+    // and by minimum range to not shifted neighbour
+    slider.shiftValues(1, 3, -100);
+    QCOMPARE(slider.values(), QVector<int>({ 10, 15, 70, 85, 95 }));
+    // nothing to shift
+    slider.shiftValues(3, 5, 10);
+
+    QCOMPARE(rangeSpy.count(), 0);
+    QCOMPARE(positionsRangeSpy.count(), 0);
+    QCOMPARE(updateSpy.count(), 2);
+    QCOMPARE(positionsShiftSpy.count(), 2);
+    QCOMPARE(shiftSpy.count(), 2);
+    QCOMPARE(shiftSpy.at(0), QList<QVariant>({ 2, 5, 45 }));
+    QCOMPARE(shiftSpy.at(1), QList<QVariant>({ 1, 3, -5 }));
+}
+
+void Tests::shiftValuesIsOneUndoStep()
+{
+    MultiSlider slider(Qt::Horizontal);
+    initSlider(slider, { 10, 20, 30, 40 });
+    slider.setUndoLimit(1024);
+    slider.setValue(0, 5);
+    slider.shiftValues(1, 4, 50);
+    QCOMPARE(slider.values(), QVector<int>({ 5, 70, 80, 90 }));
+    // a shift cut by range is undone by the applied delta
+    slider.shiftValues(1, 4, 50);
+    QCOMPARE(slider.values(), QVector<int>({ 5, 80, 90, 100 }));
+    slider.undo();
+    QCOMPARE(slider.values(), QVector<int>({ 5, 70, 80, 90 }));
+    slider.undo();
+    QCOMPARE(slider.values(), QVector<int>({ 5, 20, 30, 40 }));
+    slider.undo();
+    QCOMPARE(slider.values(), QVector<int>({ 10, 20, 30, 40 }));
+    QVERIFY(!slider.canUndo());
+    slider.redo();
+    slider.redo();
+    QCOMPARE(slider.values(), QVector<int>({ 5, 70, 80, 90 }));
+    slider.redo();
+    QCOMPARE(slider.values(), QVector<int>({ 5, 80, 90, 100 }));
+    QVERIFY(!slider.canRedo());
+}
+
+void Tests::journalUndoRedoRoundTrip()
+{
+    std::mt19937 random(2);
+    MultiSliderJournal journal(1 << 20);
+    QVector<int> values(20, 0);
+    QVector<QVector<int>> history{ values };
+    for (int step = 0; step < 50; ++step)
+    {
+        const int first = int(random() % 20);
+        QVector<int> newValues(int(random() % (20 - first)) + 1);
+        for (int& value : newValues)
+        {
+            value = int(random() % 100);
+        }
+        recordChange(journal, values, first, newValues);
+        history.append(values);
+    }
+    for (int step = 50; step > 0; --step)
+    {
+        QVERIFY(journal.canUndo());
+        undoChange(journal, values);
+        QCOMPARE(values, history.at(step - 1));
+    }
+    QVERIFY(!journal.canUndo());
+    for (int step = 1; step <= 50; ++step)
+    {
+        QVERIFY(journal.canRedo());
+        redoChange(journal, values);
+        QCOMPARE(values, history.at(step));
+    }
+    QVERIFY(!journal.canRedo());
+
+    // new change drops redo history
+    undoChange(journal, values);
+    recordChange(journal, values, 0, { 7 });
+    QVERIFY(!journal.canRedo());
+}
+
+void Tests::journalMergesDrag()
+{
+    MultiSliderJournal journal(1 << 20);
+    QVector<int> values{ 10, 20, 30, 40 };
+    recordChange(journal, values, 0, { 5 });
+    journal.beginMerge();
+    recordChange(journal, values, 1, { 25 });
+    recordChange(journal, values, 3, { 45 });
+    recordChange(journal, values, 1, { 27 });
+    journal.endMerge();
+    QCOMPARE(values, QVector<int>({ 5, 27, 30, 45 }));
+
+    // the drag is one step spanning handles it moved
+    undoChange(journal, values);
+    QCOMPARE(values, QVector<int>({ 5, 20, 30, 40 }));
+    QVERIFY(journal.canUndo());
+    undoChange(journal, values);
+    QCOMPARE(values, QVector<int>({ 10, 20, 30, 40 }));
+    redoChange(journal, values);
+    redoChange(journal, values);
+    QCOMPARE(values, QVector<int>({ 5, 27, 30, 45 }));
+
+    // changes after the merge ended are separate steps
+    recordChange(journal, values, 2, { 35 });
+    undoChange(journal, values);
+    QCOMPARE(values, QVector<int>({ 5, 27, 30, 45 }));
+}
+
+void Tests::journalTrimsOldestSteps()
+{
+    MultiSliderJournal journal(3 * journalEntrySize(1));
+    QVector<int> values{ 0, 0 };
+    for (int step = 1; step <= 5; ++step)
+    {
+        recordChange(journal, values, 0, { step });
+    }
+    for (int step = 4; step >= 2; --step)
+    {
+        QVERIFY(journal.canUndo());
+        undoChange(journal, values);
+        QCOMPARE(values.first(), step);
+    }
+    QVERIFY(!journal.canUndo());
+
+    // with nothing to undo, the nearest redo step is the one kept
+    journal.setLimit(journalEntrySize(1));
+    QVERIFY(journal.canRedo());
+    redoChange(journal, values);
+    QCOMPARE(values.first(), 3);
+    QVERIFY(!journal.canRedo());
+}
+
+void Tests::journalKeepsLastStepOverLimit()
+{
+    MultiSliderJournal journal(journalEntrySize(1));
+    QVector<int> values(10, 0);
+    recordChange(journal, values, 0, { 1 });
+    recordChange(journal, values, 0, QVector<int>(10, 2));
+    QVERIFY(journal.canUndo());
+    undoChange(journal, values);
+    QCOMPARE(values, QVector<int>({ 1, 0, 0, 0, 0, 0, 0, 0, 0, 0 }));
+    QVERIFY(!journal.canUndo());
+
+    // a new step over the limit replaces the undone one
+    recordChange(journal, values, 1, QVector<int>(9, 3));
+    QVERIFY(journal.canUndo());
+    undoChange(journal, values);
+    QCOMPARE(values, QVector<int>({ 1, 0, 0, 0, 0, 0, 0, 0, 0, 0 }));
+    QVERIFY(!journal.canUndo());
+}
+
+void Tests::automationInterpolatesCurves()
+{
+    MultiSlider slider(Qt::Horizontal);
+    initSlider(slider, { 0, 50, 100 });
+    QSignalSpy rangeSpy(&slider, &MultiSlider::valuesRangeChanged);
+    MultiSliderAutomation automation(&slider);
+    automation.setCurve(0, { { 0, 0 }, { 100, 40 } });
+    automation.setCurve(2, { { 0, 100 }, { 200, 60 } });
+    QCOMPARE(automation.duration(), 200);
+
+    automation.setTime(50);
+    QCOMPARE(slider.values(), QVector<int>({ 20, 50, 90 }));
+    // both curves are applied by one commit
+    QCOMPARE(rangeSpy.count(), 1);
+
+    // the first curve holds its last keyframe
+    automation.setTime(150);
+    QCOMPARE(slider.values(), QVector<int>({ 40, 50, 70 }));
+
+    // time going back moves cursors back
+    automation.setTime(25);
+    QCOMPARE(slider.values(), QVector<int>({ 10, 50, 95 }));
+
+    automation.setLooping(true);
+    automation.setTime(250);
+    QCOMPARE(slider.values(), QVector<int>({ 20, 50, 90 }));
+    automation.setTime(400);
+    QCOMPARE(slider.values(), QVector<int>({ 0, 50, 100 }));
+    QCOMPARE(automation.time(), qint64(400));
+}
+
+void Tests::automationStaysOutOfUndo()
+{
+    MultiSlider slider(Qt::Horizontal);
+    initSlider(slider, { 0, 50, 100 });
+    slider.setUndoLimit(1024);
+    MultiSliderAutomation automation(&slider);
+    automation.setCurve(0, { { 0, 0 }, { 100, 40 } });
+
+    slider.setValue(1, 60);
+    QVERIFY(slider.canUndo());
+    // tick which does not change values keeps history
+    automation.setTime(0);
+    QVERIFY(slider.canUndo());
+    // history is dropped once ticks move handles it was recorded with
+    automation.setTime(50);
+    QCOMPARE(slider.value(0), 20);
+    QVERIFY(!slider.canUndo());
+    QVERIFY(!slider.canRedo());
+}
+
+void Tests::recordingReplaysEachState()
+{
+    const int Min = std::numeric_limits<int>::min();
+    const int Max = std::numeric_limits<int>::max();
+    MultiSlider recorded(Qt::Horizontal);
+    initSlider(recorded, { 10, 50, 90 });
+    QByteArray stream;
+    QBuffer output(&stream);
+    QVERIFY(output.open(QIODevice::WriteOnly));
+    MultiSliderRecorder recorder(&recorded, &output);
+    recorder.start();
+
+    // states are taken after the slider and the recorder handled each change
+    QVector<SliderState> states{ sliderState(recorded) };
+    const auto takeState = [&states, &recorded]() { states.append(sliderState(recorded)); };
+    connect(&recorded, &MultiSlider::valuesRangeChanged, takeState);
+    connect(&recorded, &MultiSlider::valuesShifted, takeState);
+    connect(&recorded, &QAbstractSlider::rangeChanged, takeState);
+    connect(&recorded, &MultiSlider::countChanged, takeState);
+    connect(&recorded, &MultiSlider::minimumRangeChanged, takeState);
+
+    recorded.setValue(1, 40);
+    recorded.setValues({ 0, 50, 100 });
+    // values are clamped by the slider before the recorder sees the new range
+    recorded.setRange(Min, Min + 1000);
+    recorded.setValues({ Min, Min + 500, Min + 1000 });
+    // deltas of the whole int range
+    recorded.setRange(Max - 1000, Max);
+    recorded.setValues({ Max - 1000, Max - 1, Max });
+    recorded.setValues({ Max - 1000, Max - 900, Max - 800 });
+    // shift is cut by maximum, the recorder writes the applied delta
+    recorded.shiftValues(1, 3, 1000);
+    recorded.addToRight(2);
+    recorded.removeFromLeft(1);
+    recorded.setMinimumRange(10);
+    recorded.setValue(0, Max - 500);
+    recorder.stop();
+
+    MultiSlider replayed(Qt::Horizontal);
+    QBuffer input(&stream);
+    QVERIFY(input.open(QIODevice::ReadOnly));
+    MultiSliderPlayer player(&replayed, &input);
+    // header records: range, minimum range and layout
+    for (int i = 0; i < 3; ++i)
+    {
+        QVERIFY(player.step());
+    }
+    QVERIFY(sliderState(replayed) == states.first());
+    // each record leads to a state the recorded slider had, never to values under a stale range
+    while (player.step())
+    {
+        QVERIFY(states.contains(sliderState(replayed)));
+    }
+    QVERIFY(input.atEnd());
+    QVERIFY(sliderState(replayed) == sliderState(recorded));
+    QCOMPARE(replayed.count(), 4);
+}
+
+int main(int argc, char* argv[])
+{
+    // tests do not need a display
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+    {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    Q_INIT_RESOURCE(res);
+    QApplication app(argc, argv);
+    Tests tests;
+    return QTest::qExec(&tests, argc, argv);
+}
+
+#include "tst_multislider.moc"